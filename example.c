@@ -53,7 +53,14 @@ void init_display(uint8_t pin_sda, uint8_t pin_scl) {
   gpio_set_function(pin_scl, GPIO_FUNC_I2C);
   gpio_pull_up(pin_sda);
   gpio_pull_up(pin_scl);
-  ssd1306_init(&display, 128, 64, 0x3C, I2C_PORT, 0);
+  ssd1306_init_double_buffered(&display, 128, 64, 0x3C, I2C_PORT, 0, false);
+  ssd1306_enable_shadow(&display);
+  // Lets a failed transfer free the bus if the display holds SDA low
+  ssd1306_set_i2c_pins(&display, pin_sda, pin_scl);
+  // Up to Fast-mode Plus as the wiring allows, backing off a step after repeated errors.
+  // The test frames are the frame buffer, so it is cleared first
+  ssd1306_clear(&display);
+  ssd1306_tune_i2c(&display, 1000 * 1000, 4, 8);
 }
 
 void demo_write() {
@@ -79,7 +86,8 @@ void demo_contrast() {
     char txt[20];
     sprintf(txt, "Contrast: %d", i);
     ssd1306_draw_str(&display, 12, 14, txt, &font8x8_font);
-    ssd1306_show(&display);
+    // Only the digits that changed since the last frame are sent
+    ssd1306_show_diff(&display);
     sleep_ms(100);
     // Clamp i between 0 and 255, reverse direction at limits
     i += step;
@@ -104,6 +112,20 @@ void demo_invert() {
   sleep_ms(500);
 }
 
+void demo_effects() {
+  ssd1306_clear(&display);
+  ssd1306_draw_str(&display, 5, 5, "Effects", &font8x8_font);
+  ssd1306_draw_str(&display, 5, 25, "Run by the display", &font6x8_font);
+  ssd1306_show(&display);
+  // A few command bytes each, no frames are resent
+  ssd1306_fade(&display, SSD1306_FADE_BLINK, 1);
+  sleep_ms(3000);
+  ssd1306_effects_stop(&display);
+  ssd1306_zoom(&display, true);
+  sleep_ms(1500);
+  ssd1306_effects_stop(&display);
+}
+
 void demo_pixel_drawing() {
   uint16_t half = display.width / 2;
   ssd1306_clear(&display);
@@ -115,7 +137,8 @@ void demo_pixel_drawing() {
     uint16_t y1 = rand() % display.height;
     ssd1306_draw_pixel(&display, x0, y0);
     ssd1306_clear_pixel(&display, x1, y1);
-    ssd1306_show(&display);
+    // Only the columns and pages touched by the two pixels are sent
+    ssd1306_show_dirty(&display);
   }
 }
 
@@ -150,7 +173,11 @@ void demo_scaling_star() {
       star_x + (int16_t)(scale * 10),
       star_y + (int16_t)(scale * 15),
       scale);
-    ssd1306_show(&display);
+    // The next frame is drawn while this one is still being transmitted
+    ssd1306_async_wait(&display);
+    if (!ssd1306_show_async(&display, NULL, NULL)) {
+      ssd1306_show(&display);
+    }
     // Reverse direction if limits are reached
     if (scale > 3.0f && step > 0.0f || scale < 0.8f && step < 0.0f) {
       step = -step;
@@ -189,6 +216,43 @@ void demo_scrolling_stars() {
   ssd1306_scroll_horiz_stop(&display);
 }
 
+void demo_ticker() {
+  ssd1306_ticker_t ticker;
+
+  ssd1306_clear(&display);
+  ssd1306_draw_str(&display, 5, 5, "Ticker", &font8x8_font);
+  ssd1306_show(&display);
+  // Only the column scrolling in is sent on each step
+  if (!ssd1306_ticker_start(&display, &ticker, "Hardware scrolled text, one column at a time",
+                            &font6x8_font, 4, 50, false)) {
+    return;
+  }
+  while (ssd1306_ticker_step(&display, &ticker)) {
+    tight_loop_contents();
+  }
+}
+
+void demo_console() {
+  char txt[24];
+
+  ssd1306_clear(&display);
+  ssd1306_draw_str(&display, 5, 0, "Console", &font8x8_font);
+  ssd1306_draw_line(&display, 0, 9, display.width - 1, 9);
+  ssd1306_show(&display);
+  // The header stays put, each new line costs one page of transfer plus the header
+  ssd1306_set_fixed_rows(&display, 10);
+  for (int i = 0; i < 20; i++) {
+    ssd1306_scroll_lines(&display, 8);
+    sprintf(txt, "Log line %d", i);
+    ssd1306_draw_str(&display, 5, display.height - 8, txt, &font6x8_font);
+    ssd1306_show_dirty(&display);
+    sleep_ms(150);
+  }
+  // Back to an unrotated frame buffer for the other demos
+  ssd1306_set_fixed_rows(&display, 0);
+  ssd1306_scroll_lines(&display, -display.start_line);
+}
+
 void demo_rectangles() {
   uint16_t x_cent = display.width / 2;
   uint16_t y_cent = display.height / 2;
@@ -265,6 +329,46 @@ void demo_fills() {
   }
 }
 
+static void draw_bouncing_frame(uint16_t frame) {
+  ssd1306_clear(&display);
+  for (uint16_t i = 0; i < 6; i++) {
+    uint16_t t = (frame * (i + 2)) % (2 * (display.width - 16));
+    uint16_t x = t < display.width - 16 ? t : 2 * (display.width - 16) - t;
+    ssd1306_draw_circle(&display, x + 8, 8 + i * 9, 7);
+  }
+}
+
+static uint32_t measure_fps(bool swap) {
+  const uint16_t frames = 60;
+  uint64_t start = time_us_64();
+
+  for (uint16_t frame = 0; frame < frames; frame++) {
+    draw_bouncing_frame(frame);
+    if (swap) {
+      ssd1306_swap(&display);
+    } else {
+      ssd1306_show(&display);
+    }
+  }
+  ssd1306_async_wait(&display);
+  return (uint32_t)(frames * 1000000ull / (time_us_64() - start));
+}
+
+void demo_double_buffer() {
+  // Rendering overlaps the transfer of the previous frame when swapping
+  uint32_t fps_single = measure_fps(false);
+  uint32_t fps_double = measure_fps(true);
+  char txt[24];
+
+  ssd1306_clear(&display);
+  ssd1306_draw_str(&display, 5, 5, "Frame rate", &font8x8_font);
+  sprintf(txt, "Show: %lu fps", (unsigned long) fps_single);
+  ssd1306_draw_str(&display, 5, 25, txt, &font6x8_font);
+  sprintf(txt, "Swap: %lu fps", (unsigned long) fps_double);
+  ssd1306_draw_str(&display, 5, 37, txt, &font6x8_font);
+  ssd1306_show(&display);
+}
+
 void demo_power_onoff() {
   ssd1306_clear(&display);
   ssd1306_draw_str(&display, 5, 25, "Powering off...", &font8x8_font);
@@ -298,11 +402,14 @@ int main() {
     sleep_ms(750);
     demo_invert();
     sleep_ms(750);
+    demo_effects();
     
     demo_pixel_drawing();
     demo_scaling_star();
     demo_scrolling_stars();
     sleep_ms(750);
+    demo_ticker();
+    demo_console();
 
     demo_scroll_oversize_image();
     sleep_ms(750);
@@ -312,6 +419,8 @@ int main() {
     demo_rectangles();
     demo_ellipses();
     demo_fills();
+    demo_double_buffer();
+    sleep_ms(2000);
     demo_power_onoff();
   }
 }
@@ -9,11 +9,30 @@
 
 #include "pico/stdlib.h"
 
+// Byte order of ssd1306_image_t data
+typedef enum {
+    // Rows top to bottom, each packed MSB first into (width + 7) / 8 bytes
+    SSD1306_IMAGE_ROWS = 0,
+    // Pages of 8 rows, each width column bytes with the top row in the LSB, the same
+    // layout as display RAM. Drawn with whole-byte copies, see tools/bmp_to_h.py --layout
+    SSD1306_IMAGE_PAGES = 1,
+} ssd1306_image_format_t;
+
 typedef struct {
     uint16_t width;
     uint16_t height;
     size_t length;
     const uint8_t *data;
+    // SSD1306_IMAGE_ROWS when left out
+    uint8_t format;
 } ssd1306_image_t;
 
+// A full frame as sent to the display: the 0x40 data control byte followed by
+// width * height / 8 bytes in page order, made by tools/bmp_to_h.py --frame
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    const uint8_t *data;
+} ssd1306_frame_t;
+
 #endif // TOOLS_IMAGE_H
@@ -7,6 +7,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <hardware/i2c.h>
+#include <hardware/spi.h>
+#include <hardware/gpio.h>
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include <hardware/sync.h>
 #include "ssd1306.h"
 #include "lib/image.h"
 
@@ -28,147 +33,2110 @@ static const uint8_t SET_PRECHARGE = 0xD9;
 static const uint8_t SET_VCOM_DESEL = 0xDB;
 static const uint8_t SET_CHARGE_PUMP = 0x8D;
 
+static const uint8_t SET_SCROLL_RIGHT = 0x26;
+static const uint8_t SET_SCROLL_LEFT = 0x27;
+static const uint8_t SET_SCROLL_VERT_RIGHT = 0x29;
+static const uint8_t SET_SCROLL_VERT_LEFT = 0x2A;
+static const uint8_t SET_CONTENT_SCROLL_LEFT = 0x2D;
+static const uint8_t SET_SCROLL_STOP = 0x2E;
+static const uint8_t SET_SCROLL_START = 0x2F;
+static const uint8_t SET_VERT_SCROLL_AREA = 0xA3;
+static const uint8_t SET_FADE_BLINK = 0x23;
+static const uint8_t SET_ZOOM = 0xD6;
+
+// Settings changed but not sent yet, see ssd1306_defer_commands
+static const uint8_t PENDING_CONTRAST = 0x01;
+static const uint8_t PENDING_INVERT = 0x02;
+// Start line put back after ssd1306_show_flash sent a frame laid out from row 0
+static const uint8_t PENDING_START_LINE = 0x04;
+static const uint8_t PENDING_ALL = 0x07;
+static const uint8_t SET_PAGE_START = 0xB0;
+static const uint8_t SET_LOW_COL = 0x00;
+static const uint8_t SET_HIGH_COL = 0x10;
+
+// Commands that can travel in front of display data in one transfer
+#define MAX_DATA_HEADER_CMDS SSD1306_MAX_HEADER_CMDS
+// Commands sent by the I2C transport in a single transaction after one control byte
+#define MAX_BATCH_CMDS 32
+// Changed runs collected by ssd1306_show_diff before they are planned and sent
+#define MAX_DIFF_SPANS 32
+// Commands needed to position a horizontal-mode window and a page-mode span
+#define WINDOW_CMDS 6
+#define PAGE_CMDS 3
+// Commands to switch between horizontal and page addressing mode
+#define MODE_CMDS 2
+// Deferred settings carried in front of the next flush: contrast, invert and start line
+#define PENDING_CMDS 4
+// Most commands window_commands can produce
+#define MAX_WINDOW_CMDS (PENDING_CMDS + MODE_CMDS + WINDOW_CMDS)
+// Longest init command group
+#define MAX_INIT_CMDS 32
+// The charge pump needs time to reach its voltage before the panel is switched on
+#define CHARGE_PUMP_SETTLE_US 100000
+
+// What fill_rect does to the pixels it covers
+enum {
+  FILL_CLEAR,
+  FILL_SET,
+  FILL_INVERT,
+};
+
+// How the points of one part of a shape are plotted, decided once from its bounding box
+enum {
+  CLIP_OUTSIDE,
+  CLIP_INSIDE,
+  CLIP_PARTIAL,
+};
+
+// Steps of ssd1306_init_poll
+enum {
+  INIT_CONFIG,
+  INIT_POWER,
+  INIT_FRAME,
+  INIT_ON,
+  INIT_DONE,
+};
+// Content scroll needs two frames between steps, about 20 ms at the default clock
+#define MIN_CONTENT_SCROLL_US 20000
+// Default transaction deadline: a byte takes 90 us at 100 kHz, plus time for clock stretching
+#define TIMEOUT_BASE_US 1000
+#define TIMEOUT_BYTE_US 100
+// Failed transactions repeated by default before giving up
+#define DEFAULT_RETRIES 2
+// Half a clock period while freeing the bus, 100 kHz
+#define BUS_CLEAR_HALF_US 5
+// Oscillator frequency 8 of 15 and divide ratio 1, about 100 Hz on a 64-row panel
+#define DEFAULT_CLOCK_DIV 0x80
+// Largest ellipse radius whose midpoint decision terms fit in 32 bits
+#define MAX_ELLIPSE_RADIUS 511
+// Fewest rows the multiplex ratio can be set to
+#define MIN_MUX_ROWS 16
+// I2C rates tried by ssd1306_tune_i2c, from standard mode up in equal steps
+#define TUNE_MIN_BAUD 100000
+#define TUNE_STEP_BAUD 100000
+// Share of the fastest rate that passed given up as a safety margin
+#define TUNE_MARGIN_PERCENT 15
+
+// Devices with a flush in progress, indexed by their DMA channel
+static ssd1306_t *async_devs[NUM_DMA_CHANNELS];
+
+static uint32_t transfer_timeout(const ssd1306_t *dev, size_t len) {
+  return dev->timeout_us ? dev->timeout_us : TIMEOUT_BASE_US + len * TIMEOUT_BYTE_US;
+}
+
+static void release_async_lock(ssd1306_t *dev) {
+  if (dev->async_locked) {
+    dev->async_locked = false;
+    mutex_exit(dev->bus_lock);
+  }
+}
+
+static void finish_async(ssd1306_t *dev) {
+  // The transport has sent the last byte, or given up on it
+  if (dev->transport->async_finish) {
+    dev->transport->async_finish(dev);
+  }
+  dev->async_draining = false;
+  release_async_lock(dev);
+}
+
+static void wait_async(ssd1306_t *dev) {
+  // Transports cannot start another transfer while one is still in progress
+  uint32_t start = time_us_32();
+  uint32_t timeout = transfer_timeout(dev, dev->buff_size + SSD1306_DATA_PREFIX);
+
+  while (ssd1306_async_busy(dev)) {
+    // A DMA transfer into a hung bus never completes. Flushes handed to another core
+    // are bounded by that core's own blocking transfers
+    if (dev->dma_chan >= 0 && time_us_32() - start > timeout) {
+      dma_channel_abort(dev->dma_chan);
+      dev->stats.errors++;
+      dev->window_area = 0;
+      dev->shadow_valid = false;
+      dev->async_busy = false;
+      finish_async(dev);
+      return;
+    }
+    tight_loop_contents();
+  }
+}
+
+static bool i2c_write(ssd1306_t *dev, const uint8_t *src, size_t len) {
+  // A NACK ends the transaction at once, a held clock or data line ends it at the deadline
+  uint32_t timeout = transfer_timeout(dev, len);
+  uint32_t start = time_us_32();
+  bool ok = false;
+
+  for (uint8_t attempt = 0; !ok; attempt++) {
+    if (attempt > dev->retries) {
+      break;
+    }
+    if (attempt > 0) {
+      dev->stats.retries++;
+    }
+    int written = i2c_write_timeout_us(dev->i2c_inst, dev->i2c_addr, src, len, false, timeout);
+    dev->stats.transactions++;
+    ok = written == (int) len;
+    if (!ok) {
+      dev->stats.errors++;
+    }
+  }
+  dev->stats.max_txn_us = MAX(dev->stats.max_txn_us, time_us_32() - start);
+  if (ok) {
+    dev->stats.bytes += len;
+  }
+  return ok;
+}
+
+static bool i2c_write_cmd(ssd1306_t *dev, const uint8_t *cmds, size_t len) {
+  // Control byte 0x00 for commands, all following bytes in the transaction are commands
+  uint8_t buffer[MAX_BATCH_CMDS + 1] = {0x00};
+
+  while (len > 0) {
+    size_t count = len > MAX_BATCH_CMDS ? MAX_BATCH_CMDS : len;
+    memcpy(buffer + 1, cmds, count);
+    if (!i2c_write(dev, buffer, count + 1)) {
+      return false;
+    }
+    cmds += count;
+    len -= count;
+  }
+  return true;
+}
+
+static size_t put_i2c_header(uint8_t *dest, const uint8_t *cmds, size_t cmd_len) {
+  // Control byte 0x80 (Co set) marks a single command byte, 0x40 starts the data stream
+  for (size_t i = 0; i < cmd_len; i++) {
+    *dest++ = 0x80;
+    *dest++ = cmds[i];
+  }
+  *dest = 0x40;
+  return cmd_len * 2 + 1;
+}
+
+static bool i2c_write_data(ssd1306_t *dev, const uint8_t *cmds, size_t cmd_len,
+                           uint8_t *data, size_t len) {
+  // The header goes into the scratch bytes in front of the data, one transaction for both
+  size_t prefix = put_i2c_header(data - (cmd_len * 2 + 1), cmds, cmd_len);
+
+  return i2c_write(dev, data - prefix, prefix + len);
+}
+
+static bool i2c_write_data_async(ssd1306_t *dev, const uint8_t *cmds, size_t cmd_len,
+                                 uint8_t *data, size_t len) {
+  // One data/command word per byte, plus the command header and control byte
+  if (len > dev->buff_size ||
+      (!dev->dma_words &&
+       (dev->dma_words = (uint16_t *) malloc((dev->buff_size + SSD1306_DATA_PREFIX) * sizeof(uint16_t))) == NULL)) {
+    return false;
+  }
+  // The I2C block takes 16-bit data/command words and byte writes to it would be
+  // replicated into the command bits, so widen the header and data into words
+  uint8_t header[SSD1306_DATA_PREFIX];
+  size_t prefix = put_i2c_header(header, cmds, cmd_len);
+  size_t count = prefix + len;
+  for (size_t i = 0; i < prefix; i++) {
+    dev->dma_words[i] = header[i];
+  }
+  for (size_t i = 0; i < len; i++) {
+    dev->dma_words[prefix + i] = data[i];
+  }
+  dev->dma_words[count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+  dev->stats.transactions++;
+  dev->stats.bytes += count;
+
+  i2c_hw_t *hw = i2c_get_hw(dev->i2c_inst);
+  hw->enable = 0;
+  hw->tar = dev->i2c_addr;
+  hw->enable = 1;
+
+  dma_channel_config config = dma_channel_get_default_config(dev->dma_chan);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+  channel_config_set_read_increment(&config, true);
+  channel_config_set_write_increment(&config, false);
+  channel_config_set_dreq(&config, i2c_get_dreq(dev->i2c_inst, true));
+  dma_channel_configure(dev->dma_chan, &config, &hw->data_cmd, dev->dma_words, count, true);
+  return true;
+}
+
+static void i2c_async_done(ssd1306_t *dev) {
+  // A NACK aborts the transfer and holds the TX FIFO until the abort is cleared. Whatever
+  // the display got is unknown, so the next flush sends the window and frame in full
+  if (i2c_get_hw(dev->i2c_inst)->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    (void) i2c_get_hw(dev->i2c_inst)->clr_tx_abrt;
+    dev->stats.errors++;
+    dev->window_area = 0;
+    dev->shadow_valid = false;
+  }
+}
+
+static bool i2c_busy(ssd1306_t *dev) {
+  // The last bytes may still be draining from the TX FIFO after the DMA has finished
+  uint32_t status = i2c_get_hw(dev->i2c_inst)->status;
+  return !(status & I2C_IC_STATUS_TFE_BITS) || (status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+static bool i2c_write_wire(ssd1306_t *dev, const uint8_t *data, size_t len) {
+  // Already led by the data control byte, so it goes out as it is
+  return i2c_write(dev, data, len);
+}
+
+static bool i2c_recover(ssd1306_t *dev) {
+  // Clear an abort left by the failed transfer
+  (void) i2c_get_hw(dev->i2c_inst)->clr_tx_abrt;
+  if (dev->pin_sda == SSD1306_NO_PIN || dev->pin_scl == SSD1306_NO_PIN) {
+    return true;
+  }
+  // A controller reset in the middle of a read-back or a byte can hold SDA low until it
+  // has clocked out the rest of it. Up to nine clocks free it, then a stop condition
+  // puts the bus back to idle. The lines are driven open-drain: low as an output, or
+  // released as an input and pulled high
+  gpio_init(dev->pin_sda);
+  gpio_init(dev->pin_scl);
+  for (uint8_t i = 0; i < 9 && !gpio_get(dev->pin_sda); i++) {
+    gpio_set_dir(dev->pin_scl, GPIO_OUT);
+    sleep_us(BUS_CLEAR_HALF_US);
+    gpio_set_dir(dev->pin_scl, GPIO_IN);
+    sleep_us(BUS_CLEAR_HALF_US);
+  }
+  gpio_set_dir(dev->pin_sda, GPIO_OUT);
+  sleep_us(BUS_CLEAR_HALF_US);
+  gpio_set_dir(dev->pin_sda, GPIO_IN);
+  sleep_us(BUS_CLEAR_HALF_US);
+  bool released = gpio_get(dev->pin_sda);
+
+  gpio_set_function(dev->pin_sda, GPIO_FUNC_I2C);
+  gpio_set_function(dev->pin_scl, GPIO_FUNC_I2C);
+  return released;
+}
+
+const ssd1306_transport_t ssd1306_i2c_transport = {
+  .write_cmd = i2c_write_cmd,
+  .write_data = i2c_write_data,
+  .write_wire = i2c_write_wire,
+  .write_data_async = i2c_write_data_async,
+  .async_done = i2c_async_done,
+  .busy = i2c_busy,
+  .recover = i2c_recover,
+  // Start, address byte with its ACK and stop, plus the data control byte
+  .txn_overhead = 3,
+  // Every command in front of data needs its own Co control byte
+  .cmd_bytes = 2,
+};
+
+static bool spi_write_cmd(ssd1306_t *dev, const uint8_t *cmds, size_t len) {
+  // D/C low selects commands
+  gpio_put(dev->pin_dc, 0);
+  gpio_put(dev->pin_cs, 0);
+  spi_write_blocking(dev->spi_inst, cmds, len);
+  gpio_put(dev->pin_cs, 1);
+  dev->stats.transactions++;
+  dev->stats.bytes += len;
+  return true;
+}
+
+static void spi_begin_data(ssd1306_t *dev, const uint8_t *cmds, size_t cmd_len) {
+  gpio_put(dev->pin_cs, 0);
+  if (cmd_len > 0) {
+    gpio_put(dev->pin_dc, 0);
+    spi_write_blocking(dev->spi_inst, cmds, cmd_len);
+  }
+  // spi_write_blocking returns once the bus is idle, so D/C can switch safely
+  gpio_put(dev->pin_dc, 1);
+  dev->stats.transactions++;
+  dev->stats.bytes += cmd_len;
+}
+
+static bool spi_write_data(ssd1306_t *dev, const uint8_t *cmds, size_t cmd_len,
+                           uint8_t *data, size_t len) {
+  spi_begin_data(dev, cmds, cmd_len);
+  spi_write_blocking(dev->spi_inst, data, len);
+  gpio_put(dev->pin_cs, 1);
+  dev->stats.bytes += len;
+  return true;
+}
+
+static bool spi_write_data_async(ssd1306_t *dev, const uint8_t *cmds, size_t cmd_len,
+                                 uint8_t *data, size_t len) {
+  if (len > dev->buff_size ||
+      (!dev->dma_bytes && (dev->dma_bytes = (uint8_t *) malloc(dev->buff_size)) == NULL)) {
+    return false;
+  }
+  // The DMA reads from a copy, so the frame buffer can be drawn into while it runs
+  memcpy(dev->dma_bytes, data, len);
+  spi_begin_data(dev, cmds, cmd_len);
+  dma_channel_config config = dma_channel_get_default_config(dev->dma_chan);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+  channel_config_set_read_increment(&config, true);
+  channel_config_set_write_increment(&config, false);
+  channel_config_set_dreq(&config, spi_get_dreq(dev->spi_inst, true));
+  dma_channel_configure(dev->dma_chan, &config, &spi_get_hw(dev->spi_inst)->dr, dev->dma_bytes, len, true);
+  dev->stats.bytes += len;
+  return true;
+}
+
+static void spi_async_finish(ssd1306_t *dev) {
+  gpio_put(dev->pin_cs, 1);
+}
+
+static bool spi_busy(ssd1306_t *dev) {
+  return spi_is_busy(dev->spi_inst);
+}
+
+static void spi_reset_pulse(ssd1306_t *dev) {
+  // The datasheet asks for at least 3 us low
+  gpio_put(dev->pin_rst, 0);
+  sleep_us(10);
+  gpio_put(dev->pin_rst, 1);
+  sleep_us(10);
+}
+
+static bool spi_recover(ssd1306_t *dev) {
+  // SPI has no acknowledge to get stuck on, but a hard reset clears a confused controller
+  gpio_put(dev->pin_cs, 1);
+  if (dev->pin_rst != SSD1306_NO_PIN) {
+    spi_reset_pulse(dev);
+  }
+  return true;
+}
+
+static bool spi_write_wire(ssd1306_t *dev, const uint8_t *data, size_t len) {
+  // D/C takes the place of the I2C control byte
+  spi_begin_data(dev, NULL, 0);
+  spi_write_blocking(dev->spi_inst, data + 1, len - 1);
+  gpio_put(dev->pin_cs, 1);
+  dev->stats.bytes += len - 1;
+  return true;
+}
+
+const ssd1306_transport_t ssd1306_spi_transport = {
+  .write_cmd = spi_write_cmd,
+  .write_data = spi_write_data,
+  .write_wire = spi_write_wire,
+  .write_data_async = spi_write_data_async,
+  .async_finish = spi_async_finish,
+  .busy = spi_busy,
+  .recover = spi_recover,
+  // Chip select and D/C switching
+  .txn_overhead = 1,
+  .cmd_bytes = 1,
+};
+
+static void lock_bus(ssd1306_t *dev) {
+  // Keeps the flush scheduler off the bus, which may have started a transfer just
+  // before the flag was set
+  dev->bus_owned = true;
+  if (dev->sched_running) {
+    wait_async(dev);
+  }
+  if (dev->bus_lock) {
+    mutex_enter_blocking(dev->bus_lock);
+  }
+}
+
+static void unlock_bus(ssd1306_t *dev) {
+  if (dev->bus_lock) {
+    mutex_exit(dev->bus_lock);
+  }
+  dev->bus_owned = false;
+}
+
+static bool recover_bus(ssd1306_t *dev);
+
+static void transfer_failed(ssd1306_t *dev) {
+  // Where the address pointer was left is unknown, and settings sent along may be lost
+  dev->window_area = 0;
+  dev->pending |= PENDING_ALL;
+  // A tuned rate that keeps failing drops a step, before recovering at the slower rate
+  if (dev->retune_errors && ++dev->tune_errors >= dev->retune_errors &&
+      dev->i2c_baud > TUNE_MIN_BAUD) {
+    dev->i2c_baud = i2c_set_baudrate(dev->i2c_inst, MAX(dev->i2c_baud - TUNE_STEP_BAUD, TUNE_MIN_BAUD));
+    dev->tune_errors = 0;
+  }
+  // ssd1306_init_poll retries its own steps
+  if (dev->auto_recover && !dev->recovering && dev->init_step == INIT_DONE) {
+    recover_bus(dev);
+  }
+}
+
+static bool write_commands(ssd1306_t *dev, const uint8_t *cmds, size_t len) {
+  wait_async(dev);
+  lock_bus(dev);
+  bool ok = dev->transport->write_cmd(dev, cmds, len);
+  unlock_bus(dev);
+  if (!ok) {
+    transfer_failed(dev);
+  }
+  return ok;
+}
+
 static void write_command(ssd1306_t *dev, uint8_t cmd) {
-  // Control byte 0x00 for commands
-  uint8_t buffer[2] = {0x00, cmd};
+  write_commands(dev, &cmd, 1);
+}
+
+static void note_first_pixel(ssd1306_t *dev) {
+  if (!dev->first_pixel_us && dev->init_step == INIT_DONE) {
+    dev->first_pixel_us = time_us_32() - dev->init_start_us;
+  }
+}
+
+static void advance_window(ssd1306_t *dev, size_t len) {
+  // The controller returns to the start of the window once all of it has been written
+  if (dev->window_area) {
+    dev->window_fill = (dev->window_fill + len) % dev->window_area;
+  }
+}
+
+static bool send_data(ssd1306_t *dev, const uint8_t *cmds, size_t cmd_len,
+                      uint8_t *data, size_t len) {
+  bool ok = true;
+
+  lock_bus(dev);
+  if (cmd_len > MAX_DATA_HEADER_CMDS) {
+    ok = dev->transport->write_cmd(dev, cmds, cmd_len);
+    cmd_len = 0;
+  }
+  // Transports may use the bytes in front of the data as scratch. Frame buffers reserve
+  // SSD1306_DATA_PREFIX bytes there so this stays inside the allocation
+  uint8_t saved[SSD1306_DATA_PREFIX];
+
+  memcpy(saved, data - SSD1306_DATA_PREFIX, SSD1306_DATA_PREFIX);
+  ok = ok && dev->transport->write_data(dev, cmds, cmd_len, data, len);
+  if (ok) {
+    advance_window(dev, len);
+    note_first_pixel(dev);
+  }
+  // Put back before anything else can take the bus and read the frame
+  memcpy(data - SSD1306_DATA_PREFIX, saved, SSD1306_DATA_PREFIX);
+  unlock_bus(dev);
+  if (!ok) {
+    transfer_failed(dev);
+  }
+  return ok;
+}
+
+static bool write_data(ssd1306_t *dev, const uint8_t *cmds, size_t cmd_len,
+                       uint8_t *data, size_t len) {
+  wait_async(dev);
+  return send_data(dev, cmds, cmd_len, data, len);
+}
+
+static uint32_t header_cost(const ssd1306_t *dev, size_t cmd_len) {
+  return dev->transport->txn_overhead + cmd_len * dev->transport->cmd_bytes;
+}
+
+static size_t pending_commands(ssd1306_t *dev, uint8_t *cmds) {
+  size_t n = 0;
+
+  if (dev->pending & PENDING_CONTRAST) {
+    cmds[n++] = SET_CONTRAST;
+    cmds[n++] = dev->contrast;
+  }
+  if (dev->pending & PENDING_INVERT) {
+    cmds[n++] = SET_NORM_INV | dev->inverted;
+  }
+  if (dev->pending & PENDING_START_LINE) {
+    cmds[n++] = SET_DISP_START_LINE | dev->start_line;
+  }
+  dev->pending = 0;
+  return n;
+}
+
+static size_t window_commands(ssd1306_t *dev, uint8_t *cmds, uint8_t col_start, uint8_t col_end,
+                              uint8_t page_start, uint8_t page_end) {
+  size_t n = pending_commands(dev, cmds);
+
+  // Windows wrap across pages only in horizontal addressing mode
+  if (dev->page_mode) {
+    cmds[n++] = SET_MEM_ADDR;
+    cmds[n++] = 0x00;
+    dev->page_mode = false;
+  }
+  // Either half of the window can be left out when it is unchanged and the last one
+  // was written in full, leaving the address pointer back at its start
+  bool at_start = dev->window_area && dev->window_fill == 0;
+  if (!at_start || col_start != dev->window_col_start || col_end != dev->window_col_end) {
+    cmds[n++] = SET_COL_ADDR;
+    cmds[n++] = col_start;
+    cmds[n++] = col_end;
+  }
+  if (!at_start || page_start != dev->window_page_start || page_end != dev->window_page_end) {
+    cmds[n++] = SET_PAGE_ADDR;
+    cmds[n++] = page_start;
+    cmds[n++] = page_end;
+  }
+  dev->window_col_start = col_start;
+  dev->window_col_end = col_end;
+  dev->window_page_start = page_start;
+  dev->window_page_end = page_end;
+  dev->window_area = (col_end - col_start + 1) * (page_end - page_start + 1);
+  dev->window_fill = 0;
+  return n;
+}
+
+static size_t page_commands(ssd1306_t *dev, uint8_t *cmds, uint8_t col, uint8_t page) {
+  size_t n = pending_commands(dev, cmds);
+
+  // Page mode moves the address pointer outside the window
+  dev->window_area = 0;
+  if (!dev->page_mode) {
+    cmds[n++] = SET_MEM_ADDR;
+    cmds[n++] = 0x02;
+    dev->page_mode = true;
+  }
+  cmds[n++] = SET_PAGE_START | page;
+  cmds[n++] = SET_LOW_COL | (col & 0x0F);
+  cmds[n++] = SET_HIGH_COL | (col >> 4);
+  return n;
+}
+
+static void dma_irq_handler(void) {
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+    ssd1306_t *dev = async_devs[ch];
+
+    if (dev && dma_channel_get_irq0_status(ch)) {
+      dma_channel_acknowledge_irq0(ch);
+      if (dev->transport->async_done) {
+        dev->transport->async_done(dev);
+      }
+      // The last bytes may still be leaving the FIFO. Rather than wait for them here,
+      // ssd1306_async_busy finishes the transfer once the transport is idle
+      dev->async_draining = true;
+      dev->async_busy = false;
+      if (dev->async_cb) {
+        dev->async_cb(dev, dev->async_user_data);
+      }
+    }
+  }
+}
+
+static bool claim_dma(ssd1306_t *dev) {
+  static bool irq_installed = false;
+  int ch = dma_claim_unused_channel(false);
+
+  if (ch < 0) {
+    return false;
+  }
+  if (!irq_installed) {
+    irq_add_shared_handler(DMA_IRQ_0, dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+    irq_installed = true;
+  }
+  dev->dma_chan = ch;
+  async_devs[ch] = dev;
+  dma_channel_set_irq0_enabled(ch, true);
+  return true;
+}
+
+// Frame-sized buffers cover the whole panel, so they stay large enough whatever rows
+// ssd1306_set_rows drives
+static size_t panel_size(const ssd1306_t *dev) {
+  return dev->width * (dev->panel_height / 8);
+}
+
+static uint8_t *alloc_frame(size_t size) {
+  // Allocate extra room in front for the command header and control byte used when writing
+  uint8_t *frame = (uint8_t *) malloc(size + SSD1306_DATA_PREFIX);
+
+  // Advance pointer so it points to the display data
+  return frame ? frame + SSD1306_DATA_PREFIX : NULL;
+}
+
+static void free_frame(uint8_t *frame) {
+  if (frame) {
+    // Move pointer back to original for free
+    free(frame - SSD1306_DATA_PREFIX);
+  }
+}
+
+static void sync_shadow(ssd1306_t *dev, const uint8_t *frame, uint16_t col_start,
+                        uint16_t cols, uint16_t page_start, uint16_t pages) {
+  if (!dev->shadow) {
+    return;
+  }
+  size_t offset = page_start * dev->width + col_start;
+  if (cols == dev->width) {
+    memcpy(dev->shadow + offset, frame + offset, cols * pages);
+    dev->shadow_valid |= pages == dev->pages;
+    return;
+  }
+  for (uint16_t page = 0; page < pages; page++, offset += dev->width) {
+    memcpy(dev->shadow + offset, frame + offset, cols);
+  }
+}
+
+static void reset_dirty(ssd1306_t *dev) {
+  dev->dirty_x_min = dev->width;
+  dev->dirty_x_max = 0;
+  dev->dirty_page_min = dev->pages;
+  dev->dirty_page_max = 0;
+}
+
+static void mark_dirty(ssd1306_t *dev, uint16_t x_min, uint16_t x_max,
+                       uint16_t page_min, uint16_t page_max) {
+  if (x_min < dev->dirty_x_min) {
+    dev->dirty_x_min = x_min;
+  }
+  if (x_max > dev->dirty_x_max) {
+    dev->dirty_x_max = x_max;
+  }
+  if (page_min < dev->dirty_page_min) {
+    dev->dirty_page_min = page_min;
+  }
+  if (page_max > dev->dirty_page_max) {
+    dev->dirty_page_max = page_max;
+  }
+}
+
+static void mark_rows_dirty(ssd1306_t *dev, int32_t x_min, int32_t y_min, int32_t x_max, int32_t y_max) {
+  x_min = MAX(x_min, 0);
+  y_min = MAX(y_min, 0);
+  x_max = MIN(x_max, dev->width - 1);
+  y_max = MIN(y_max, dev->height - 1);
+  uint16_t top = (y_min + dev->start_line) % dev->height;
+  uint16_t bottom = (y_max + dev->start_line) % dev->height;
+
+  // Rows across the end of display RAM continue from its first row
+  if (top <= bottom) {
+    mark_dirty(dev, x_min, x_max, top >> 3, bottom >> 3);
+  } else {
+    mark_dirty(dev, x_min, x_max, 0, dev->pages - 1);
+  }
+}
+
+static bool write_window(ssd1306_t *dev, uint16_t x_min, uint16_t x_max,
+                         uint16_t page_min, uint16_t page_max) {
+  uint16_t cols = x_max - x_min + 1;
+  uint8_t cmds[MAX_DATA_HEADER_CMDS];
+  size_t cmd_len = window_commands(dev, cmds, x_min, x_max, page_min, page_max);
+  uint8_t *row = dev->buff + page_min * dev->width + x_min;
+
+  if (cols == dev->width) {
+    // Full-width pages are contiguous in the buffer and go out in one transfer
+    if (!write_data(dev, cmds, cmd_len, row, cols * (page_max - page_min + 1))) {
+      return false;
+    }
+  } else {
+    // The controller wraps to the next page at the window edge, so send row by row
+    // with the window commands leading the first one
+    for (uint16_t page = page_min; page <= page_max; page++) {
+      if (!write_data(dev, cmds, cmd_len, row, cols)) {
+        return false;
+      }
+      cmd_len = 0;
+      row += dev->width;
+    }
+  }
+  sync_shadow(dev, dev->buff, x_min, cols, page_min, page_max - page_min + 1);
+  return true;
+}
+
+// Init commands for the display based on the SSD1306 datasheet, in two groups so that
+// ssd1306_init_poll can let the charge pump settle before the panel is switched on
+static size_t config_commands(const ssd1306_t *dev, uint8_t *cmds) {
+  const uint8_t config[] = {
+      // Display off
+      SET_DISP,
+      // Timing and driving scheme
+      SET_MUX_RATIO, (uint8_t)(dev->height - 1),
+      SET_DISP_OFFSET, dev->display_offset,
+      SET_DISP_START_LINE,
+      // Resolution and layout
+      SET_SEG_REMAP | 0x01,
+      SET_COM_OUT_DIR | 0x08,
+      SET_COM_PIN_CFG, (dev->width > 2 * dev->panel_height) ? 0x02 : 0x12,
+      // Display
+      SET_CONTRAST, 0xFF,
+      SET_ENTIRE_ON,
+      SET_NORM_INV,
+      SET_DISP_CLK_DIV, dev->clock_div,
+  };
+
+  memcpy(cmds, config, sizeof(config));
+  return sizeof(config);
+}
+
+static size_t power_commands(const ssd1306_t *dev, uint8_t *cmds) {
+  const uint8_t power[] = {
+      // Charge pump
+      SET_CHARGE_PUMP, (dev->external_vcc ? 0x10 : 0x14),
+      SET_PRECHARGE, (dev->external_vcc ? 0x22 : 0xF1),
+
+      SET_VCOM_DESEL, 0x30,
+      // Address setting
+      SET_MEM_ADDR, 0x00,  // Horizontal
+      // No scrolling left over from before a soft reset
+      SET_SCROLL_STOP,
+  };
+
+  memcpy(cmds, power, sizeof(power));
+  return sizeof(power);
+}
+
+static bool run_init_commands(ssd1306_t *dev) {
+  uint8_t cmds[2 * MAX_INIT_CMDS];
+  size_t n = config_commands(dev, cmds);
+
+  n += power_commands(dev, cmds + n);
+  // Display on
+  cmds[n++] = SET_DISP | 0x01;
+  dev->init_step = INIT_DONE;
+  dev->display_on = true;
+  return write_commands(dev, cmds, n);
+}
+
+static bool recover_bus(ssd1306_t *dev) {
+  dev->recovering = true;
+  dev->stats.recoveries++;
+  bool ok = !dev->transport->recover || dev->transport->recover(dev);
+
+  // The init sequence again, followed by the settings in use instead of its defaults.
+  // Hardware effects are stopped, the display is only switched on if it was on
+  uint8_t cmds[2 * MAX_INIT_CMDS];
+  size_t n = config_commands(dev, cmds);
+
+  n += power_commands(dev, cmds + n);
+  dev->pending = PENDING_ALL;
+  n += pending_commands(dev, cmds + n);
+  cmds[n++] = SET_FADE_BLINK;
+  cmds[n++] = SSD1306_FADE_OFF;
+  cmds[n++] = SET_ZOOM;
+  cmds[n++] = dev->zoom;
+  if (dev->display_on) {
+    cmds[n++] = SET_DISP | 0x01;
+  }
+  dev->fade = SSD1306_FADE_OFF;
+  dev->scrolling = false;
+  dev->page_mode = false;
+  dev->window_area = 0;
+  // Sent directly, a failed transfer handed to another core still holds async_busy
+  lock_bus(dev);
+  ok = ok && dev->transport->write_cmd(dev, cmds, n);
+  unlock_bus(dev);
+  if (!ok) {
+    dev->pending = PENDING_ALL;
+  }
+
+  // Display RAM may have been cleared or half written
+  dev->shadow_valid = false;
+  mark_dirty(dev, 0, dev->width - 1, 0, dev->pages - 1);
+  dev->recovering = false;
+  return ok;
+}
+
+bool ssd1306_recover(ssd1306_t *dev) {
+  wait_async(dev);
+  return recover_bus(dev);
+}
+
+static void draw_pixel(ssd1306_t *dev, uint16_t x, uint16_t y, bool color) {
+  if (x < dev->width && y < dev->height) {
+    // Rows are stored in display RAM order, which is rotated by the start line
+    y += dev->start_line;
+    if (y >= dev->height) {
+      y -= dev->height;
+    }
+    mark_dirty(dev, x, x, y >> 3, y >> 3);
+    // Shorthands for y / 8 and y % 8
+    if (color) {
+      dev->buff[x + dev->width * (y >> 3)] |= 0x01u << (y & 7);
+    } else {
+      dev->buff[x + dev->width * (y >> 3)] &= ~(0x01u << (y & 7));
+    }
+  }
+}
+
+static void fill_rows(ssd1306_t *dev, uint16_t x, uint16_t x_end,
+                      uint16_t y, uint16_t y_end, uint8_t op) {
+  uint16_t cols = x_end - x;
+  uint16_t page_first = y >> 3;
+  uint16_t page_last = (y_end - 1) >> 3;
+
+  // Each covered byte is written once: partial pages at the top and bottom through a mask
+  // of their rows, whole pages set or cleared outright
+  for (uint16_t page = page_first; page <= page_last; page++) {
+    uint8_t mask = 0xFF;
+    if (page == page_first) {
+      mask &= 0xFF << (y & 7);
+    }
+    if (page == page_last) {
+      mask &= 0xFF >> (7 - ((y_end - 1) & 7));
+    }
+    uint8_t *row = dev->buff + page * dev->width + x;
+
+    if (mask == 0xFF && op != FILL_INVERT) {
+      memset(row, op == FILL_SET ? 0xFF : 0x00, cols);
+      continue;
+    }
+    switch (op) {
+    case FILL_SET:
+      for (uint16_t i = 0; i < cols; i++) {
+        row[i] |= mask;
+      }
+      break;
+    case FILL_CLEAR:
+      for (uint16_t i = 0; i < cols; i++) {
+        row[i] &= ~mask;
+      }
+      break;
+    default:
+      for (uint16_t i = 0; i < cols; i++) {
+        row[i] ^= mask;
+      }
+      break;
+    }
+  }
+  mark_dirty(dev, x, x_end - 1, page_first, page_last);
+}
+
+static void fill_rect(ssd1306_t *dev, int16_t x_in, int16_t y_in,
+                      uint16_t width, uint16_t height, uint8_t op) {
+  int32_t x = MAX(x_in, 0);
+  int32_t y = MAX(y_in, 0);
+  int32_t x_end = MIN(x_in + (int32_t) width, (int32_t) dev->width);
+  int32_t y_end = MIN(y_in + (int32_t) height, (int32_t) dev->height);
+
+  if (x >= x_end || y >= y_end) {
+    return;
+  }
+  // Rows are stored in display RAM order, rotated by the start line. A rectangle across
+  // the end of display RAM continues from its first row
+  uint16_t top = (y + dev->start_line) % dev->height;
+  uint16_t rows = y_end - y;
+
+  if (top + rows <= dev->height) {
+    fill_rows(dev, x, x_end, top, top + rows, op);
+  } else {
+    fill_rows(dev, x, x_end, top, dev->height, op);
+    fill_rows(dev, x, x_end, 0, top + rows - dev->height, op);
+  }
+}
+
+static void blit_columns(ssd1306_t *dev, int x, int y, const uint8_t *columns,
+                         uint16_t width, uint8_t rows, bool opaque) {
+  // Rows of the columns that are on the display
+  uint8_t mask = rows >= 8 ? 0xFF : (1u << rows) - 1;
+  if (y <= -8 || y >= dev->height) {
+    return;
+  }
+  if (y < 0) {
+    mask &= 0xFF << -y;
+  }
+  if (y + 8 > dev->height) {
+    mask &= 0xFF >> (y + 8 - dev->height);
+  }
+  // Columns are stored LSB at the top like display RAM, so each one is written shifted
+  // across the page holding its top row and the next, which follows the start line
+  // rotation around to page 0. When y is on a page boundary only one page is touched
+  uint16_t row = (y + dev->start_line + dev->height) % dev->height;
+  uint8_t shift = row & 7;
+  uint16_t page = row >> 3;
+  uint16_t next_page = (page + 1) % dev->pages;
+  uint8_t *top = dev->buff + page * dev->width;
+  uint8_t *bottom = dev->buff + next_page * dev->width;
+  uint16_t keep = ~((uint16_t) mask << shift);
+  int x_min = MAX(x, 0);
+  int x_end = MIN(x + width, (int) dev->width);
+
+  if (x_min >= x_end) {
+    return;
+  }
+  for (int col = x_min; col < x_end; col++) {
+    uint16_t bits = (uint16_t)(columns[col - x] & mask) << shift;
+    if (opaque) {
+      top[col] = (top[col] & keep) | bits;
+    } else {
+      top[col] |= bits;
+    }
+  }
+  mark_dirty(dev, x_min, x_end - 1, page, page);
+  if ((uint16_t) ~keep >> 8) {
+    for (int col = x_min; col < x_end; col++) {
+      uint16_t bits = (uint16_t)(columns[col - x] & mask) << shift;
+      if (opaque) {
+        bottom[col] = (bottom[col] & (keep >> 8)) | (bits >> 8);
+      } else {
+        bottom[col] |= bits >> 8;
+      }
+    }
+    mark_dirty(dev, x_min, x_end - 1, next_page, next_page);
+  }
+}
+
+static void draw_char(ssd1306_t *dev, int x, int y, uint8_t ch,
+                      const ssd1306_font_t *font, bool opaque) {
+  const uint8_t *glyph = font->data + (ch - font->first) * font->width;
+
+  blit_columns(dev, x, y, glyph, font->width, font->height, opaque);
+}
+
+static void draw_str(ssd1306_t *dev, int x, int y, const char *str,
+                     const ssd1306_font_t *font, bool opaque) {
+  const uint8_t last = font->first + font->count;
+
+  for (; *str; str++, x += font->width) {
+    uint8_t ch = (uint8_t) *str;
+    // Skip characters not in the font
+    if (ch >= font->first && ch < last) {
+      draw_char(dev, x, y, ch, font, opaque);
+    }
+  }
+}
+
+static bool prepare(ssd1306_t *dev, uint16_t width, uint16_t height,
+                    const ssd1306_transport_t *transport, bool external_vcc) {
+  dev->width = width;
+  dev->height = height;
+  dev->panel_height = height;
+  dev->display_offset = 0;
+  dev->clock_div = DEFAULT_CLOCK_DIV;
+  dev->pages = height / 8;
+  dev->transport = transport;
+  dev->external_vcc = external_vcc;
+  dev->buff_size = width * dev->pages;
+  dev->dma_chan = -1;
+  dev->dma_words = NULL;
+  dev->dma_bytes = NULL;
+  dev->async_busy = false;
+  dev->async_draining = false;
+  dev->async_locked = false;
+  dev->async_cb = NULL;
+  dev->async_user_data = NULL;
+  dev->front_buff = NULL;
+  dev->copy_forward = false;
+  dev->shadow = NULL;
+  dev->shadow_valid = false;
+  dev->page_mode = false;
+  dev->sched_running = false;
+  dev->show_requested = false;
+  dev->bus_owned = false;
+  dev->region_count = 0;
+  ssd1306_set_bus_budget(dev, 0);
+  ssd1306_set_chunking(dev, 0, NULL, NULL);
+  dev->bus_lock = NULL;
+  dev->start_line = 0;
+  dev->fixed_rows = 0;
+  dev->contrast = 0xFF;
+  dev->fade = SSD1306_FADE_OFF;
+  dev->zoom = false;
+  // As left by the init sequence
+  dev->inverted = false;
+  dev->display_on = false;
+  dev->scrolling = false;
+  dev->pending = 0;
+  dev->defer_commands = false;
+  dev->frame_cmd_len = 0;
+  dev->frame_failed = false;
+  dev->window_area = 0;
+  dev->init_step = INIT_CONFIG;
+  dev->init_page = 0;
+  dev->init_start_us = time_us_32();
+  dev->first_pixel_us = 0;
+  dev->pin_sda = SSD1306_NO_PIN;
+  dev->pin_scl = SSD1306_NO_PIN;
+  ssd1306_set_timeout(dev, 0, DEFAULT_RETRIES);
+  dev->auto_recover = true;
+  dev->recovering = false;
+  dev->i2c_baud = 0;
+  dev->retune_errors = 0;
+  dev->tune_errors = 0;
+  ssd1306_reset_stats(dev);
+  ssd1306_reset_scheduler_stats(dev);
+
+  if ((dev->buff = alloc_frame(panel_size(dev))) == NULL) {
+    return false;
+  }
+  // Contents of both the buffer and the display RAM are undefined until the first full flush
+  reset_dirty(dev);
+  mark_dirty(dev, 0, width - 1, 0, dev->pages - 1);
+  return true;
+}
+
+bool ssd1306_init_transport(ssd1306_t *dev, uint16_t width, uint16_t height,
+                            const ssd1306_transport_t *transport, bool external_vcc) {
+  if (!prepare(dev, width, height, transport, external_vcc)) {
+    return false;
+  }
+  // No acknowledge from the address, or no panel at all
+  if (!run_init_commands(dev)) {
+    ssd1306_deinit(dev);
+    return false;
+  }
+  return true;
+}
+
+bool ssd1306_init_transport_async(ssd1306_t *dev, uint16_t width, uint16_t height,
+                                  const ssd1306_transport_t *transport, bool external_vcc) {
+  if (!prepare(dev, width, height, transport, external_vcc)) {
+    return false;
+  }
+  // Blank unless drawn into before the first frame goes out
+  memset(dev->buff, 0, dev->buff_size);
+  return true;
+}
+
+bool ssd1306_init_async(ssd1306_t *dev, uint16_t width, uint16_t height,
+                        uint8_t i2c_addr, i2c_inst_t *i2c_inst, bool external_vcc) {
+  dev->i2c_addr = i2c_addr;
+  dev->i2c_inst = i2c_inst;
+  return ssd1306_init_transport_async(dev, width, height, &ssd1306_i2c_transport, external_vcc);
+}
+
+bool ssd1306_init_poll(ssd1306_t *dev) {
+  uint8_t cmds[MAX_INIT_CMDS];
+
+  // One short transfer per call, a failed one is retried on the next call
+  switch (dev->init_step) {
+  case INIT_CONFIG:
+    if (write_commands(dev, cmds, config_commands(dev, cmds))) {
+      dev->init_step = INIT_POWER;
+    }
+    return false;
+  case INIT_POWER:
+    if (write_commands(dev, cmds, power_commands(dev, cmds))) {
+      dev->init_wait_us = time_us_32();
+      dev->init_step = INIT_FRAME;
+    }
+    return false;
+  case INIT_FRAME:
+    // The first frame is written a page at a time while the charge pump settles, so
+    // the panel doesn't show whatever was left in display RAM. Everything drawn so far
+    // goes out with it, while drawing on pages already sent stays dirty
+    if (dev->init_page == 0) {
+      reset_dirty(dev);
+    }
+    if (write_window(dev, 0, dev->width - 1, dev->init_page, dev->init_page) &&
+        ++dev->init_page == dev->pages) {
+      dev->init_step = INIT_ON;
+    }
+    return false;
+  case INIT_ON:
+    if (time_us_32() - dev->init_wait_us < CHARGE_PUMP_SETTLE_US) {
+      return false;
+    }
+    cmds[0] = SET_DISP | 0x01;
+    if (!write_commands(dev, cmds, 1)) {
+      return false;
+    }
+    dev->display_on = true;
+    dev->first_pixel_us = time_us_32() - dev->init_start_us;
+    dev->init_step = INIT_DONE;
+    return true;
+  default:
+    return true;
+  }
+}
+
+bool ssd1306_init(ssd1306_t *dev, uint16_t width, uint16_t height,
+                  uint8_t i2c_addr, i2c_inst_t *i2c_inst, bool external_vcc) {
+  dev->i2c_addr = i2c_addr;
+  dev->i2c_inst = i2c_inst;
+  return ssd1306_init_transport(dev, width, height, &ssd1306_i2c_transport, external_vcc);
+}
+
+bool ssd1306_init_spi(ssd1306_t *dev, uint16_t width, uint16_t height, spi_inst_t *spi_inst,
+                      uint8_t pin_dc, uint8_t pin_cs, uint8_t pin_rst, bool external_vcc) {
+  dev->spi_inst = spi_inst;
+  dev->pin_dc = pin_dc;
+  dev->pin_cs = pin_cs;
+  dev->pin_rst = pin_rst;
+
+  gpio_init(pin_dc);
+  gpio_set_dir(pin_dc, GPIO_OUT);
+  gpio_init(pin_cs);
+  gpio_set_dir(pin_cs, GPIO_OUT);
+  gpio_put(pin_cs, 1);
+  if (pin_rst != SSD1306_NO_PIN) {
+    gpio_init(pin_rst);
+    gpio_set_dir(pin_rst, GPIO_OUT);
+    spi_reset_pulse(dev);
+  }
+  return ssd1306_init_transport(dev, width, height, &ssd1306_spi_transport, external_vcc);
+}
+
+bool ssd1306_enable_double_buffer(ssd1306_t *dev, bool copy_forward) {
+  if (!dev->front_buff && (dev->front_buff = alloc_frame(panel_size(dev))) == NULL) {
+    return false;
+  }
+  dev->copy_forward = copy_forward;
+  return true;
+}
+
+bool ssd1306_init_double_buffered(ssd1306_t *dev, uint16_t width, uint16_t height, uint8_t i2c_addr,
+                                  i2c_inst_t *i2c_inst, bool external_vcc, bool copy_forward) {
+  if (!ssd1306_init(dev, width, height, i2c_addr, i2c_inst, external_vcc)) {
+    return false;
+  }
+  if (!ssd1306_enable_double_buffer(dev, copy_forward)) {
+    ssd1306_deinit(dev);
+    return false;
+  }
+  return true;
+}
+
+void ssd1306_deinit(ssd1306_t *dev) {
+  ssd1306_stop_scheduler(dev);
+  if (dev->dma_chan >= 0) {
+    wait_async(dev);
+    dma_channel_set_irq0_enabled(dev->dma_chan, false);
+    async_devs[dev->dma_chan] = NULL;
+    dma_channel_unclaim(dev->dma_chan);
+    dev->dma_chan = -1;
+  }
+  free(dev->dma_words);
+  dev->dma_words = NULL;
+  free(dev->dma_bytes);
+  dev->dma_bytes = NULL;
+  free(dev->shadow);
+  dev->shadow = NULL;
+  free_frame(dev->buff);
+  free_frame(dev->front_buff);
+  dev->buff = NULL;
+  dev->front_buff = NULL;
+}
+
+void ssd1306_power_off(ssd1306_t *dev) {
+  if (dev->display_on) {
+    write_command(dev, SET_DISP);
+    dev->display_on = false;
+  }
+}
+
+void ssd1306_power_on(ssd1306_t *dev) {
+  if (dev->display_on) {
+    return;
+  }
+  // Settings changed while the display was off go out with display on
+  uint8_t cmds[PENDING_CMDS + 1];
+  size_t n = pending_commands(dev, cmds);
+
+  cmds[n++] = SET_DISP | 0x01;
+  write_commands(dev, cmds, n);
+  dev->display_on = true;
+}
+
+static void set_pending(ssd1306_t *dev, uint8_t setting) {
+  dev->pending |= setting;
+  // Changes made while the display is off wait for ssd1306_resume
+  if (!dev->defer_commands && dev->display_on) {
+    uint8_t cmds[PENDING_CMDS];
+    write_commands(dev, cmds, pending_commands(dev, cmds));
+  }
+}
+
+void ssd1306_resume(ssd1306_t *dev) {
+  if (dev->display_on) {
+    return;
+  }
+  // Display RAM and settings survive sleep, only what changed since is sent: the changed
+  // part of the frame carrying any held-back settings, then display on
+  ssd1306_show_dirty(dev);
+  uint8_t cmds[PENDING_CMDS + 1];
+  size_t n = pending_commands(dev, cmds);
+
+  cmds[n++] = SET_DISP | 0x01;
+  write_commands(dev, cmds, n);
+  dev->display_on = true;
+}
+
+void ssd1306_defer_commands(ssd1306_t *dev, bool defer) {
+  dev->defer_commands = defer;
+  if (!defer && dev->pending) {
+    set_pending(dev, 0);
+  }
+}
+
+void ssd1306_clear(ssd1306_t *dev) {
+  memset(dev->buff, 0, dev->buff_size);
+  mark_dirty(dev, 0, dev->width - 1, 0, dev->pages - 1);
+}
+
+void ssd1306_invert(ssd1306_t *dev, uint8_t inv) {
+  if ((inv & 1) != dev->inverted) {
+    dev->inverted = inv & 1;
+    set_pending(dev, PENDING_INVERT);
+  }
+}
+
+static bool send_frame(ssd1306_t *dev, uint8_t *frame) {
+  // Address window and pixel data go out in a single transaction
+  uint8_t cmds[MAX_DATA_HEADER_CMDS];
+  size_t cmd_len = window_commands(dev, cmds, 0, dev->width - 1, 0, dev->pages - 1);
+
+  if (!send_data(dev, cmds, cmd_len, frame, dev->buff_size)) {
+    return false;
+  }
+  sync_shadow(dev, frame, 0, dev->width, 0, dev->pages);
+  return true;
+}
+
+static bool write_frame(ssd1306_t *dev, uint8_t *frame) {
+  wait_async(dev);
+  return send_frame(dev, frame);
+}
+
+void ssd1306_prepare_frame(ssd1306_t *dev) {
+  // Settings changed from here on wait for the next frame instead of racing this one
+  dev->frame_cmd_len = window_commands(dev, dev->frame_cmds, 0, dev->width - 1, 0, dev->pages - 1);
+  dev->frame_failed = false;
+  reset_dirty(dev);
+}
+
+bool ssd1306_send_frame(ssd1306_t *dev, uint8_t *frame) {
+  lock_bus(dev);
+  bool ok = dev->transport->write_data(dev, dev->frame_cmds, dev->frame_cmd_len, frame, dev->buff_size);
+  if (ok) {
+    advance_window(dev, dev->buff_size);
+    note_first_pixel(dev);
+    sync_shadow(dev, frame, 0, dev->width, 0, dev->pages);
+  }
+  unlock_bus(dev);
+  dev->frame_failed = !ok;
+  return ok;
+}
+
+void ssd1306_finish_frame(ssd1306_t *dev) {
+  if (dev->frame_failed) {
+    dev->frame_failed = false;
+    mark_dirty(dev, 0, dev->width - 1, 0, dev->pages - 1);
+    transfer_failed(dev);
+  }
+}
+
+// Address window as window_commands last set it, and whether the address pointer is
+// back at its start so an unchanged half can be left out
+typedef struct {
+  bool at_start;
+  uint8_t col_start;
+  uint8_t col_end;
+  uint8_t page_start;
+  uint8_t page_end;
+} window_state_t;
+
+static window_state_t current_window(const ssd1306_t *dev) {
+  return (window_state_t){dev->window_area && dev->window_fill == 0, dev->window_col_start,
+                          dev->window_col_end, dev->window_page_start, dev->window_page_end};
+}
+
+// Window commands window_commands sends for the next window, which is then written in full
+static size_t window_cmd_count(window_state_t *window, uint8_t col_start, uint8_t col_end,
+                               uint8_t page_start, uint8_t page_end) {
+  size_t n = 0;
+
+  if (!window->at_start || col_start != window->col_start || col_end != window->col_end) {
+    n += WINDOW_CMDS / 2;
+  }
+  if (!window->at_start || page_start != window->page_start || page_end != window->page_end) {
+    n += WINDOW_CMDS / 2;
+  }
+  *window = (window_state_t){true, col_start, col_end, page_start, page_end};
+  return n;
+}
+
+static uint32_t window_cost(const ssd1306_t *dev, uint16_t x_min, uint16_t x_max,
+                            uint16_t page_min, uint16_t page_max) {
+  uint32_t cols = x_max - x_min + 1;
+  uint32_t pages = page_max - page_min + 1;
+  // Rows narrower than the display each start a transfer of their own
+  uint32_t transfers = cols == dev->width ? 1 : pages;
+
+  return header_cost(dev, WINDOW_CMDS) + (transfers - 1) * dev->transport->txn_overhead + cols * pages;
+}
+
+static void next_slice(const ssd1306_t *dev, uint16_t col, uint16_t page, uint16_t *cols, uint16_t *pages) {
+  // Whole pages when the chunk holds at least one, otherwise part of a page, since a
+  // window only wraps back to its own first column
+  if (col == 0 && dev->chunk_size >= dev->width) {
+    *cols = dev->width;
+    *pages = MIN(dev->chunk_size / dev->width, dev->pages - page);
+  } else {
+    *cols = MIN(dev->chunk_size, dev->width - col);
+    *pages = 1;
+  }
+}
+
+static bool write_chunked(ssd1306_t *dev) {
+  uint16_t col = 0;
+  uint16_t page = 0;
+
+  while (page < dev->pages) {
+    uint16_t cols, pages;
+    next_slice(dev, col, page, &cols, &pages);
+    if ((col || page) && dev->yield_cb) {
+      dev->yield_cb(dev, dev->yield_user_data);
+    }
+    if (!write_window(dev, col, col + cols - 1, page, page + pages - 1)) {
+      return false;
+    }
+    col += cols;
+    if (col == dev->width) {
+      col = 0;
+      page += pages;
+    }
+  }
+  return true;
+}
+
+bool ssd1306_show(ssd1306_t *dev) {
+  bool ok = dev->chunk_size ? write_chunked(dev) : write_frame(dev, dev->buff);
+
+  if (ok) {
+    reset_dirty(dev);
+  }
+  return ok;
+}
+
+static bool start_async(ssd1306_t *dev, uint8_t *frame, ssd1306_async_cb_t callback, void *user_data) {
+  if (!dev->transport->write_data_async || ssd1306_async_busy(dev) ||
+      (dev->dma_chan < 0 && !claim_dma(dev))) {
+    return false;
+  }
+  // Held until the transfer completes. Not waited for, since the scheduler starts
+  // flushes from a timer interrupt
+  if (dev->bus_lock && !mutex_try_enter(dev->bus_lock, NULL)) {
+    return false;
+  }
+  dev->async_locked = dev->bus_lock != NULL;
+  bool page_mode = dev->page_mode;
+  uint8_t pending = dev->pending;
+  uint8_t cmds[MAX_DATA_HEADER_CMDS];
+  size_t cmd_len = window_commands(dev, cmds, 0, dev->width - 1, 0, dev->pages - 1);
+
+  dev->async_cb = callback;
+  dev->async_user_data = user_data;
+  dev->async_busy = true;
+  if (!dev->transport->write_data_async(dev, cmds, cmd_len, frame, dev->buff_size)) {
+    // The header was not sent after all
+    dev->page_mode = page_mode;
+    dev->pending = pending;
+    dev->window_area = 0;
+    dev->async_busy = false;
+    release_async_lock(dev);
+    return false;
+  }
+  advance_window(dev, dev->buff_size);
+  note_first_pixel(dev);
+  sync_shadow(dev, frame, 0, dev->width, 0, dev->pages);
+  return true;
+}
+
+bool ssd1306_show_flash(ssd1306_t *dev, const ssd1306_frame_t *frame) {
+  if (frame->width != dev->width || frame->height != dev->height || !dev->transport->write_wire) {
+    return false;
+  }
+  // A DMA flush may still be feeding the bus even when no commands go out below
+  wait_async(dev);
+  // Nothing is sent for the window when the last one covered the whole display, then
+  // the frame goes out in a single transfer straight from flash. The frame is laid out
+  // from display RAM row 0, a scrolled start line is put back by the next flush
+  uint8_t cmds[1 + MAX_WINDOW_CMDS];
+  size_t cmd_len = 0;
+
+  if (dev->start_line) {
+    cmds[cmd_len++] = SET_DISP_START_LINE;
+    dev->pending &= ~PENDING_START_LINE;
+  }
+  cmd_len += window_commands(dev, cmds + cmd_len, 0, dev->width - 1, 0, dev->pages - 1);
+  if (dev->start_line) {
+    dev->pending |= PENDING_START_LINE;
+  }
+  // The display no longer matches the frame buffer, the next flush sends all of it
+  dev->shadow_valid = false;
+  mark_dirty(dev, 0, dev->width - 1, 0, dev->pages - 1);
+
+  if (cmd_len > 0 && !write_commands(dev, cmds, cmd_len)) {
+    return false;
+  }
+  lock_bus(dev);
+  bool ok = dev->transport->write_wire(dev, frame->data, dev->buff_size + 1);
+  if (ok) {
+    advance_window(dev, dev->buff_size);
+    note_first_pixel(dev);
+  }
+  unlock_bus(dev);
+  if (!ok) {
+    transfer_failed(dev);
+  }
+  return ok;
+}
+
+bool ssd1306_show_async(ssd1306_t *dev, ssd1306_async_cb_t callback, void *user_data) {
+  if (!start_async(dev, dev->buff, callback, user_data)) {
+    return false;
+  }
+  reset_dirty(dev);
+  return true;
+}
+
+bool ssd1306_swap(ssd1306_t *dev) {
+  if (!dev->front_buff) {
+    return ssd1306_show(dev);
+  }
+  // The previous front buffer is about to be drawn into again
+  wait_async(dev);
+  uint8_t *frame = dev->buff;
+  dev->buff = dev->front_buff;
+  dev->front_buff = frame;
+
+  bool ok = start_async(dev, frame, NULL, NULL) || write_frame(dev, frame);
+
+  if (dev->copy_forward) {
+    memcpy(dev->buff, frame, dev->buff_size);
+    if (ok) {
+      reset_dirty(dev);
+    }
+  } else {
+    // The new back buffer still holds the frame from two swaps ago
+    mark_dirty(dev, 0, dev->width - 1, 0, dev->pages - 1);
+  }
+  return ok;
+}
+
+static void sched_done(ssd1306_t *dev, void *user_data) {
+  (void) user_data;
+  dev->sched_stats.busy_us += time_us_32() - dev->sched_transfer_us;
+}
+
+static bool sched_tick(repeating_timer_t *timer) {
+  ssd1306_t *dev = (ssd1306_t *) timer->user_data;
+
+  // Requests made while a transfer is running wait for a later tick
+  if (dev->show_requested && !dev->bus_owned && !ssd1306_async_busy(dev)) {
+    dev->show_requested = false;
+    dev->sched_transfer_us = time_us_32();
+    if (start_async(dev, dev->buff, sched_done, NULL)) {
+      dev->sched_stats.frames++;
+    } else {
+      dev->show_requested = true;
+    }
+  }
+  return true;
+}
+
+bool ssd1306_start_scheduler(ssd1306_t *dev, uint16_t fps) {
+  if (dev->sched_running || fps == 0) {
+    return false;
+  }
+  // Get the DMA channel and any transport buffers in place outside interrupt context
+  wait_async(dev);
+  if (!start_async(dev, dev->buff, NULL, NULL)) {
+    return false;
+  }
+  reset_dirty(dev);
+  wait_async(dev);
+
+  dev->show_requested = false;
+  ssd1306_reset_scheduler_stats(dev);
+  // A negative delay keeps ticks on a fixed rate however long the callback takes
+  if (!add_repeating_timer_us(-(int64_t)(1000000 / fps), sched_tick, dev, &dev->sched_timer)) {
+    return false;
+  }
+  dev->sched_running = true;
+  return true;
+}
+
+void ssd1306_stop_scheduler(ssd1306_t *dev) {
+  if (!dev->sched_running) {
+    return;
+  }
+  cancel_repeating_timer(&dev->sched_timer);
+  dev->sched_running = false;
+  dev->show_requested = false;
+  wait_async(dev);
+}
+
+void ssd1306_request_show(ssd1306_t *dev) {
+  dev->sched_stats.requests++;
+  if (dev->show_requested) {
+    dev->sched_stats.coalesced++;
+  }
+  dev->show_requested = true;
+}
+
+ssd1306_sched_stats_t ssd1306_scheduler_stats(ssd1306_t *dev) {
+  ssd1306_sched_stats_t stats = dev->sched_stats;
+
+  stats.elapsed_us = time_us_32() - dev->sched_start_us;
+  if (stats.elapsed_us > 0) {
+    stats.fps = (uint64_t) stats.frames * 1000000 / stats.elapsed_us;
+    stats.duty_percent = MIN((uint64_t) stats.busy_us * 100 / stats.elapsed_us, 100);
+  }
+  return stats;
+}
+
+void ssd1306_reset_scheduler_stats(ssd1306_t *dev) {
+  memset(&dev->sched_stats, 0, sizeof(dev->sched_stats));
+  dev->sched_start_us = time_us_32();
+}
+
+bool ssd1306_async_busy(ssd1306_t *dev) {
+  if (dev->async_busy) {
+    return true;
+  }
+  if (!dev->async_draining) {
+    return false;
+  }
+  if (dev->transport->busy && dev->transport->busy(dev)) {
+    return true;
+  }
+  // Also called from the scheduler's timer interrupt, only one caller may finish it
+  uint32_t irq_state = save_and_disable_interrupts();
+  if (dev->async_draining) {
+    finish_async(dev);
+  }
+  restore_interrupts(irq_state);
+  return false;
+}
+
+void ssd1306_async_wait(ssd1306_t *dev) {
+  wait_async(dev);
+}
+
+void ssd1306_set_chunking(ssd1306_t *dev, uint16_t chunk_bytes, ssd1306_yield_cb_t yield, void *user_data) {
+  dev->chunk_size = chunk_bytes;
+  dev->yield_cb = yield;
+  dev->yield_user_data = user_data;
+}
+
+void ssd1306_set_bus_lock(ssd1306_t *dev, mutex_t *lock) {
+  // A DMA flush in progress releases the lock it took
+  wait_async(dev);
+  dev->bus_lock = lock;
+}
+
+// Cost of a window written in one transfer, with the commands window_commands would send
+// for it after the window before. Chunked slices are whole pages or part of one page
+static uint32_t slice_cost(const ssd1306_t *dev, window_state_t *window, uint16_t col,
+                           uint16_t cols, uint16_t page, uint16_t pages) {
+  size_t cmds = window_cmd_count(window, col, col + cols - 1, page, page + pages - 1);
+
+  return header_cost(dev, cmds) + cols * pages;
+}
+
+ssd1306_chunk_info_t ssd1306_chunk_info(const ssd1306_t *dev) {
+  // Priced from the window last sent, as the next ssd1306_show would find it
+  window_state_t window = current_window(dev);
+  uint32_t mode_cost = dev->page_mode ? MODE_CMDS * dev->transport->cmd_bytes : 0;
+  uint32_t single = slice_cost(dev, &window, 0, dev->width, 0, dev->pages) + mode_cost;
+  ssd1306_chunk_info_t info = {1, single, 0};
+
+  if (!dev->chunk_size) {
+    return info;
+  }
+  uint16_t col = 0;
+  uint16_t page = 0;
+  uint32_t total = 0;
+
+  window = current_window(dev);
+  info.slices = 0;
+  info.max_slice_cost = 0;
+  while (page < dev->pages) {
+    uint16_t cols, pages;
+    next_slice(dev, col, page, &cols, &pages);
+    uint32_t cost = slice_cost(dev, &window, col, cols, page, pages) + (info.slices ? 0 : mode_cost);
+
+    info.slices++;
+    info.max_slice_cost = MAX(info.max_slice_cost, cost);
+    total += cost;
+    col += cols;
+    if (col == dev->width) {
+      col = 0;
+      page += pages;
+    }
+  }
+  info.overhead = total - single;
+  return info;
+}
+
+bool ssd1306_show_dirty(ssd1306_t *dev) {
+  if (dev->dirty_x_min > dev->dirty_x_max) {
+    return true;
+  }
+  if (!write_window(dev, dev->dirty_x_min, dev->dirty_x_max, dev->dirty_page_min, dev->dirty_page_max)) {
+    return false;
+  }
+  reset_dirty(dev);
+  return true;
+}
+
+// Finds the display RAM pages holding the region's rows at the current start line
+static void place_region(ssd1306_t *dev, ssd1306_region_t *region) {
+  uint16_t top = (region->row_min + dev->start_line) % dev->height;
+  uint16_t bottom = (region->row_max + dev->start_line) % dev->height;
+
+  if (top <= bottom) {
+    region->page_min = top >> 3;
+    region->page_max = bottom >> 3;
+  } else {
+    region->page_min = 0;
+    region->page_max = dev->pages - 1;
+  }
+}
+
+int ssd1306_add_region(ssd1306_t *dev, const char *name, int16_t x, int16_t y,
+                       uint16_t width, uint16_t height, uint16_t max_hz) {
+  int32_t x_end = MIN(x + width, dev->width);
+  int32_t y_end = MIN(y + height, dev->height);
+  x = MAX(x, 0);
+  y = MAX(y, 0);
+
+  if (dev->region_count == SSD1306_MAX_REGIONS || x >= x_end || y >= y_end) {
+    return -1;
+  }
+  ssd1306_region_t *region = &dev->regions[dev->region_count];
+  region->name = name;
+  region->x_min = x;
+  region->x_max = x_end - 1;
+  region->row_min = y;
+  region->row_max = y_end - 1;
+  place_region(dev, region);
+  region->interval_us = max_hz ? 1000000 / max_hz : 0;
+  // Due straight away, with the whole area still to be sent
+  region->last_sent_us = time_us_32() - region->interval_us;
+  region->dirty_x_min = region->x_min;
+  region->dirty_x_max = region->x_max;
+  region->dirty_page_min = region->page_min;
+  region->dirty_page_max = region->page_max;
+  return dev->region_count++;
+}
+
+ssd1306_region_t *ssd1306_find_region(ssd1306_t *dev, const char *name) {
+  for (uint8_t i = 0; i < dev->region_count; i++) {
+    if (strcmp(dev->regions[i].name, name) == 0) {
+      return &dev->regions[i];
+    }
+  }
+  return NULL;
+}
+
+void ssd1306_set_bus_budget(ssd1306_t *dev, uint32_t bytes_per_sec) {
+  dev->bus_budget = bytes_per_sec;
+  dev->bus_credit = 0;
+  dev->bus_credit_us = time_us_32();
+}
+
+static void fold_dirty(ssd1306_t *dev) {
+  if (dev->dirty_x_min > dev->dirty_x_max) {
+    return;
+  }
+  for (uint8_t i = 0; i < dev->region_count; i++) {
+    ssd1306_region_t *region = &dev->regions[i];
+    uint8_t x_min = MAX(dev->dirty_x_min, region->x_min);
+    uint8_t x_max = MIN(dev->dirty_x_max, region->x_max);
+    uint8_t page_min = MAX(dev->dirty_page_min, region->page_min);
+    uint8_t page_max = MIN(dev->dirty_page_max, region->page_max);
+
+    if (x_min > x_max || page_min > page_max) {
+      continue;
+    }
+    region->dirty_x_min = MIN(region->dirty_x_min, x_min);
+    region->dirty_x_max = MAX(region->dirty_x_max, x_max);
+    region->dirty_page_min = MIN(region->dirty_page_min, page_min);
+    region->dirty_page_max = MAX(region->dirty_page_max, page_max);
+    // Later regions overlapping this one only get changes it doesn't cover
+    if (x_min == dev->dirty_x_min && x_max == dev->dirty_x_max &&
+        page_min == dev->dirty_page_min && page_max == dev->dirty_page_max) {
+      break;
+    }
+  }
+  reset_dirty(dev);
+}
+
+void ssd1306_show_regions(ssd1306_t *dev) {
+  uint32_t now = time_us_32();
+
+  fold_dirty(dev);
+  if (dev->bus_budget) {
+    // Credit builds up at the budget rate, up to a quarter second or one full frame
+    uint32_t limit = MAX(dev->bus_budget / 4, window_cost(dev, 0, dev->width - 1, 0, dev->pages - 1));
+    uint64_t credit = dev->bus_credit + (uint64_t) (now - dev->bus_credit_us) * dev->bus_budget / 1000000;
 
-  i2c_write_blocking(dev->i2c_inst, dev->i2c_addr, buffer, 2, false);
+    dev->bus_credit = MIN(credit, limit);
+    dev->bus_credit_us = now;
+  }
+  while (true) {
+    // Serve the region that has waited longest, so a fast one can't starve the rest
+    ssd1306_region_t *next = NULL;
+    for (uint8_t i = 0; i < dev->region_count; i++) {
+      ssd1306_region_t *region = &dev->regions[i];
+
+      if (region->dirty_x_min <= region->dirty_x_max &&
+          now - region->last_sent_us >= region->interval_us &&
+          (!next || now - region->last_sent_us > now - next->last_sent_us)) {
+        next = region;
+      }
+    }
+    if (!next) {
+      return;
+    }
+    if (dev->bus_budget) {
+      uint32_t cost = window_cost(dev, next->dirty_x_min, next->dirty_x_max,
+                                  next->dirty_page_min, next->dirty_page_max);
+      if (cost > dev->bus_credit) {
+        return;
+      }
+      dev->bus_credit -= cost;
+    }
+    if (!write_window(dev, next->dirty_x_min, next->dirty_x_max, next->dirty_page_min, next->dirty_page_max)) {
+      return;
+    }
+    next->last_sent_us = now;
+    next->dirty_x_min = next->x_max + 1;
+    next->dirty_x_max = next->x_min;
+    next->dirty_page_min = next->page_max;
+    next->dirty_page_max = next->page_min;
+  }
 }
 
-static void run_init_commands(ssd1306_t *dev) {
-  // Init commands for the display based on the SSD1306 datasheet
-  const uint8_t init_commands[] = {
-      // Display off
-      SET_DISP,
-      // Timing and driving scheme
-      SET_MUX_RATIO, (uint8_t)(dev->height - 1),
-      SET_DISP_OFFSET, 0x00,
-      SET_DISP_START_LINE,
-      // Resolution and layout
-      SET_SEG_REMAP | 0x01,
-      SET_COM_OUT_DIR | 0x08,
-      SET_COM_PIN_CFG, (dev->width > 2 * dev->height) ? 0x02 : 0x12,
-      // Display
-      SET_CONTRAST, 0xFF,
-      SET_ENTIRE_ON,
-      SET_NORM_INV,
-      SET_DISP_CLK_DIV, 0x80,
-      // Charge pump
-      SET_CHARGE_PUMP, (dev->external_vcc ? 0x10 : 0x14),
-      SET_PRECHARGE, (dev->external_vcc ? 0x22 : 0xF1),
+bool ssd1306_enable_shadow(ssd1306_t *dev) {
+  if (!dev->shadow && (dev->shadow = (uint8_t *) malloc(panel_size(dev))) == NULL) {
+    return false;
+  }
+  // The display contents are unknown to the shadow until the first full flush
+  dev->shadow_valid = false;
+  return true;
+}
 
-      SET_VCOM_DESEL, 0x30,
-      // Address setting
-      SET_MEM_ADDR, 0x00,  // Horizontal
-      // Display on
-      SET_DISP | 0x01,
-  };
+static uint32_t span_len(const ssd1306_span_t *span) {
+  return span->col_end - span->col_start + 1;
+}
 
-  for (size_t i = 0; i < sizeof(init_commands); i++) {
-    // TODO: Check return value in case of failure
-    write_command(dev, init_commands[i]);
-  }
+static uint32_t window_run_cost(const ssd1306_t *dev, window_state_t *window, const ssd1306_span_t *run) {
+  return header_cost(dev, window_cmd_count(window, run->col_start, run->col_end, run->page, run->page)) +
+         span_len(run);
 }
 
-static void draw_pixel(ssd1306_t *dev, uint16_t x, uint16_t y, bool color) {
-  if (x < dev->width && y < dev->height) {
-    // Shorthands for y / 8 and y % 8
-    if (color) {
-      dev->buff[x + dev->width * (y >> 3)] |= 0x01u << (y & 7);
+ssd1306_plan_t ssd1306_plan_spans(const ssd1306_t *dev, const ssd1306_span_t *spans, size_t count) {
+  // Bytes each transfer costs before its data: transaction overhead and commands. Spans
+  // are merged against a full window header, as ssd1306_show_spans does
+  const uint32_t window_header = header_cost(dev, WINDOW_CMDS);
+  const uint32_t page_header = header_cost(dev, PAGE_CMDS);
+  // Switching the addressing mode rides along in the first header
+  const uint32_t mode_switch = MODE_CMDS * dev->transport->cmd_bytes;
+  uint32_t window_total = dev->page_mode ? mode_switch : 0;
+  uint32_t page_total = dev->page_mode ? 0 : mode_switch;
+  uint16_t window_transfers = 0, page_transfers = 0;
+  window_state_t window = current_window(dev);
+  ssd1306_span_t run = {0};
+
+  for (size_t i = 0; i < count; i++) {
+    bool same_page = i > 0 && spans[i].page == spans[i - 1].page;
+    uint32_t gap = same_page ? (uint32_t)(spans[i].col_start - spans[i - 1].col_end - 1) : UINT32_MAX;
+    // Gaps cheaper than a new header are sent along with their neighbours. A window only
+    // costs the commands for the half that differs from the window before it
+    if (gap < window_header) {
+      run.col_end = spans[i].col_end;
     } else {
-      dev->buff[x + dev->width * (y >> 3)] &= ~(0x01u << (y & 7));
+      if (i > 0) {
+        window_total += window_run_cost(dev, &window, &run);
+      }
+      run = spans[i];
+      window_transfers++;
+    }
+    if (gap < page_header) {
+      page_total += gap + span_len(&spans[i]);
+    } else {
+      page_total += page_header + span_len(&spans[i]);
+      page_transfers++;
     }
   }
+  if (count > 0) {
+    window_total += window_run_cost(dev, &window, &run);
+  }
+  window_state_t frame = current_window(dev);
+  uint32_t full_cost = header_cost(dev, window_cmd_count(&frame, 0, dev->width - 1, 0, dev->pages - 1)) +
+                       (dev->page_mode ? mode_switch : 0) + dev->buff_size;
+  ssd1306_plan_t plan = {SSD1306_PLAN_FULL, full_cost, 1};
+  if (window_total < plan.cost) {
+    plan = (ssd1306_plan_t){SSD1306_PLAN_WINDOWS, window_total, window_transfers};
+  }
+  if (page_total < plan.cost) {
+    plan = (ssd1306_plan_t){SSD1306_PLAN_PAGES, page_total, page_transfers};
+  }
+  return plan;
 }
 
-static void fill_rect(ssd1306_t *dev, int16_t x_in, int16_t y_in,
-                      uint16_t width, uint16_t height, bool color) {
-  uint16_t x = x_in < 0 ? 0 : x_in;
-  uint16_t y = y_in < 0 ? 0 : y_in;
-  uint16_t x_end = x + width;
-  uint16_t y_end = y + height;
-  x_end = x_end > dev->width ? dev->width : x_end;
-  y_end = y_end > dev->height ? dev->height : y_end;
+static bool write_span(ssd1306_t *dev, ssd1306_plan_mode_t mode, uint16_t page,
+                       uint16_t col_start, uint16_t col_end) {
+  uint8_t cmds[MAX_DATA_HEADER_CMDS];
+  size_t cmd_len = mode == SSD1306_PLAN_PAGES
+      ? page_commands(dev, cmds, col_start, page)
+      : window_commands(dev, cmds, col_start, col_end, page, page);
+  size_t offset = page * dev->width + col_start;
 
-  for (uint16_t i = x; i < x_end; ++i) {
-    for (uint16_t j = y; j < y_end; ++j) {
-      draw_pixel(dev, i, j, color);
+  if (!write_data(dev, cmds, cmd_len, dev->buff + offset, col_end - col_start + 1)) {
+    return false;
+  }
+  sync_shadow(dev, dev->buff, col_start, col_end - col_start + 1, page, 1);
+  return true;
+}
+
+bool ssd1306_show_spans(ssd1306_t *dev, const ssd1306_span_t *spans, size_t count) {
+  if (count == 0) {
+    return true;
+  }
+  ssd1306_plan_t plan = ssd1306_plan_spans(dev, spans, count);
+  if (plan.mode == SSD1306_PLAN_FULL) {
+    return write_frame(dev, dev->buff);
+  }
+  uint32_t header = header_cost(dev, plan.mode == SSD1306_PLAN_PAGES ? PAGE_CMDS : WINDOW_CMDS);
+  ssd1306_span_t run = spans[0];
+
+  for (size_t i = 1; i < count; i++) {
+    if (spans[i].page == run.page && spans[i].col_start - run.col_end - 1u < header) {
+      run.col_end = spans[i].col_end;
+      continue;
     }
+    if (!write_span(dev, plan.mode, run.page, run.col_start, run.col_end)) {
+      return false;
+    }
+    run = spans[i];
+  }
+  return write_span(dev, plan.mode, run.page, run.col_start, run.col_end);
+}
+
+static uint16_t first_changed_byte(uint32_t diff) {
+  // Little-endian, the lowest set byte of the difference is the leftmost column
+  uint16_t i = 0;
+  while (!(diff & 0xFFu)) {
+    diff >>= 8;
+    i++;
+  }
+  return i;
+}
+
+static uint16_t last_changed_byte(uint32_t diff) {
+  uint16_t i = 3;
+  while (!(diff & 0xFF000000u)) {
+    diff <<= 8;
+    i--;
+  }
+  return i;
+}
+
+static size_t add_diff_span(ssd1306_t *dev, ssd1306_span_t *spans, size_t count,
+                            uint16_t page, uint16_t first, uint16_t last, bool *ok) {
+  // Extend the previous span when the change continues it
+  if (count > 0 && spans[count - 1].page == page && spans[count - 1].col_end + 1 >= first) {
+    spans[count - 1].col_end = last;
+    return count;
   }
+  if (count == MAX_DIFF_SPANS) {
+    *ok &= ssd1306_show_spans(dev, spans, count);
+    count = 0;
+  }
+  spans[count++] = (ssd1306_span_t){page, first, last};
+  return count;
 }
 
-static void draw_char(ssd1306_t *dev, uint16_t x, uint16_t y, const char *chr,
-                      const ssd1306_font_t *font) {
-  for (uint8_t i = 0; i < font->width; i++) {
-    uint8_t line = font->data[(*chr - font->first) * font->width + i];
-    for (uint8_t j = 0; j < font->height; j++) {
-      draw_pixel(dev, x + i, y + j, (line & 0x01u));
-      line >>= 1;
+bool ssd1306_show_diff(ssd1306_t *dev) {
+  if (!dev->shadow_valid) {
+    return ssd1306_show(dev);
+  }
+  ssd1306_span_t spans[MAX_DIFF_SPANS];
+  size_t count = 0;
+  // Runs that fail keep their old shadow bytes, so the next call sends them again
+  bool ok = true;
+
+  for (uint16_t page = 0; page < dev->pages; page++) {
+    const uint8_t *row = dev->buff + page * dev->width;
+    const uint8_t *old = dev->shadow + page * dev->width;
+    // Word compare needs both rows aligned, which holds whenever the width is a multiple of 4
+    uint16_t words = ((uintptr_t) row | (uintptr_t) old) & 3 ? 0 : dev->width / 4;
+    uint16_t x = 0;
+
+    for (uint16_t w = 0; w < words; w++, x += 4) {
+      uint32_t diff = ((const uint32_t *) row)[w] ^ ((const uint32_t *) old)[w];
+      if (diff) {
+        count = add_diff_span(dev, spans, count, page,
+                              x + first_changed_byte(diff), x + last_changed_byte(diff), &ok);
+      }
+    }
+    // Columns left over after the last whole word
+    for (; x < dev->width; x++) {
+      if (row[x] != old[x]) {
+        count = add_diff_span(dev, spans, count, page, x, x, &ok);
+      }
     }
   }
+  ok &= ssd1306_show_spans(dev, spans, count);
+  if (ok) {
+    reset_dirty(dev);
+  }
+  return ok;
 }
 
-bool ssd1306_init(ssd1306_t *dev, uint16_t width, uint16_t height,
-                  uint8_t i2c_addr, i2c_inst_t *i2c_inst, bool external_vcc) {
-  dev->width = width;
-  dev->height = height;
-  dev->pages = height / 8;
-  dev->i2c_addr = i2c_addr;
-  dev->i2c_inst = i2c_inst;
-  dev->external_vcc = external_vcc;
-  dev->buff_size = width * dev->pages;
+void ssd1306_reset_stats(ssd1306_t *dev) {
+  memset(&dev->stats, 0, sizeof(dev->stats));
+}
 
-  // Allocate one extra byte for the control byte prefix used when writing
-  if ((dev->buff = (uint8_t *) malloc(dev->buff_size + 1)) == NULL) {
-    return false;
+void ssd1306_set_timeout(ssd1306_t *dev, uint32_t timeout_us, uint8_t retries) {
+  dev->timeout_us = timeout_us;
+  dev->retries = retries;
+}
+
+void ssd1306_set_i2c_pins(ssd1306_t *dev, uint8_t pin_sda, uint8_t pin_scl) {
+  dev->pin_sda = pin_sda;
+  dev->pin_scl = pin_scl;
+}
+
+static bool tune_step(ssd1306_t *dev, uint32_t baud, uint8_t frames) {
+  i2c_set_baudrate(dev->i2c_inst, baud);
+  for (uint8_t i = 0; i < frames; i++) {
+    if (!send_frame(dev, dev->buff)) {
+      return false;
+    }
   }
-  // Advance pointer so dev->buff points to the display data; dev->buff - 1 is the control byte
-  (dev->buff)++;
-  run_init_commands(dev);
-  ssd1306_scroll_horiz_stop(dev);
   return true;
 }
 
-void ssd1306_deinit(ssd1306_t *dev) {
-  if (dev->buff) {
-    // Move pointer back to original for free
-    free(dev->buff - 1);
-    dev->buff = NULL;
+uint32_t ssd1306_tune_i2c(ssd1306_t *dev, uint32_t max_baud, uint8_t frames, uint16_t retune_errors) {
+  if (dev->transport != &ssd1306_i2c_transport) {
+    return 0;
+  }
+  wait_async(dev);
+  // Every failure has to show, the bus is only recovered once at the end
+  uint8_t retries = dev->retries;
+  bool auto_recover = dev->auto_recover;
+  dev->retries = 0;
+  dev->auto_recover = false;
+  dev->retune_errors = 0;
+
+  // The controller can't be read back over I2C, so only NACKs and timeouts show up.
+  // Corruption starts a little below the rate where those do, hence the margin
+  uint32_t stable = 0;
+  bool failed = false;
+  for (uint32_t baud = TUNE_MIN_BAUD; baud <= max_baud; baud += TUNE_STEP_BAUD) {
+    if (!tune_step(dev, baud, frames)) {
+      failed = true;
+      break;
+    }
+    stable = baud;
+  }
+  uint32_t baud = stable - stable * TUNE_MARGIN_PERCENT / 100;
+  dev->i2c_baud = i2c_set_baudrate(dev->i2c_inst, MAX(baud, TUNE_MIN_BAUD));
+
+  dev->retries = retries;
+  dev->auto_recover = auto_recover;
+  dev->retune_errors = retune_errors;
+  dev->tune_errors = 0;
+  if (failed) {
+    recover_bus(dev);
+  }
+  // Test frames were the frame buffer itself, the display ends up showing it
+  if (!ssd1306_show(dev) || stable == 0) {
+    return 0;
   }
+  return dev->i2c_baud;
 }
 
-void ssd1306_power_off(ssd1306_t *dev) {
-  write_command(dev, SET_DISP);
+void ssd1306_mark_dirty(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  int16_t x_end = x + (int16_t) width;
+  int16_t y_end = y + (int16_t) height;
+  x = x < 0 ? 0 : x;
+  y = y < 0 ? 0 : y;
+  x_end = x_end > (int16_t) dev->width ? (int16_t) dev->width : x_end;
+  y_end = y_end > (int16_t) dev->height ? (int16_t) dev->height : y_end;
+
+  if (x < x_end && y < y_end) {
+    mark_rows_dirty(dev, x, y, x_end - 1, y_end - 1);
+  }
 }
 
-void ssd1306_power_on(ssd1306_t *dev) {
-  write_command(dev, SET_DISP | 0x01);
+void ssd1306_contrast(ssd1306_t *p, uint8_t val) {
+  if (val != p->contrast) {
+    p->contrast = val;
+    set_pending(p, PENDING_CONTRAST);
+  }
 }
 
-void ssd1306_clear(ssd1306_t *dev) {
-  memset(dev->buff, 0, dev->buff_size);
+void ssd1306_fade(ssd1306_t *dev, ssd1306_fade_t mode, uint8_t interval) {
+  uint8_t cmds[] = {SET_FADE_BLINK, (uint8_t) mode | (interval & 0x0F)};
+
+  dev->fade = mode;
+  write_commands(dev, cmds, sizeof(cmds));
 }
 
-void ssd1306_invert(ssd1306_t *dev, uint8_t inv) {
-  write_command(dev, SET_NORM_INV | (inv & 1));
+bool ssd1306_zoom(ssd1306_t *dev, bool enable) {
+  // Zoom doubles rows in pairs, which needs the alternative COM pin layout of taller panels
+  if (enable && dev->width > 2 * dev->panel_height) {
+    return false;
+  }
+  uint8_t cmds[] = {SET_ZOOM, enable};
+
+  dev->zoom = enable;
+  write_commands(dev, cmds, sizeof(cmds));
+  return true;
 }
 
-void ssd1306_show(ssd1306_t *dev) {
-  uint8_t data[] = {
-    SET_COL_ADDR, 0x00, dev->width - 1,
-    SET_PAGE_ADDR, 0x00, dev->pages - 1
-  };
-  for (size_t i = 0; i < sizeof(data); i++) {
-    write_command(dev, data[i]);
+void ssd1306_effects_stop(ssd1306_t *dev) {
+  uint8_t cmds[6];
+  size_t n = 0;
+
+  if (dev->fade != SSD1306_FADE_OFF) {
+    // Fading leaves the contrast lowered, put back the last value set
+    cmds[n++] = SET_FADE_BLINK;
+    cmds[n++] = SSD1306_FADE_OFF;
+    cmds[n++] = SET_CONTRAST;
+    cmds[n++] = dev->contrast;
+    dev->fade = SSD1306_FADE_OFF;
+    dev->pending &= ~PENDING_CONTRAST;
+  }
+  if (dev->zoom) {
+    cmds[n++] = SET_ZOOM;
+    cmds[n++] = 0x00;
+    dev->zoom = false;
+  }
+  if (n > 0) {
+    write_commands(dev, cmds, n);
   }
-  // Control byte 0x40 for data
-  *(dev->buff - 1) = 0x40;
-  i2c_write_blocking(dev->i2c_inst, dev->i2c_addr, dev->buff - 1, dev->buff_size + 1, false);
 }
 
-void ssd1306_contrast(ssd1306_t *p, uint8_t val) {
-  write_command(p, SET_CONTRAST);
-  write_command(p, val);
+bool ssd1306_set_clock(ssd1306_t *dev, uint8_t divide, uint8_t osc_freq) {
+  if (divide < 1 || divide > 16 || osc_freq > 15) {
+    return false;
+  }
+  uint8_t clock_div = (osc_freq << 4) | (divide - 1);
+
+  if (clock_div != dev->clock_div) {
+    uint8_t cmds[] = {SET_DISP_CLK_DIV, clock_div};
+    dev->clock_div = clock_div;
+    write_commands(dev, cmds, sizeof(cmds));
+  }
+  return true;
+}
+
+bool ssd1306_set_rows(ssd1306_t *dev, uint8_t rows, uint8_t offset) {
+  if (rows % 8 || rows < MIN_MUX_ROWS || rows > dev->panel_height || offset >= dev->panel_height) {
+    return false;
+  }
+  // The frame, front and shadow buffers keep their allocations, only the part in use
+  // changes. The DMA staging buffers are sized on first use, so they are dropped to be
+  // sized again
+  wait_async(dev);
+  dev->height = rows;
+  dev->pages = rows / 8;
+  dev->buff_size = dev->width * dev->pages;
+  dev->display_offset = offset;
+  free(dev->dma_words);
+  dev->dma_words = NULL;
+  free(dev->dma_bytes);
+  dev->dma_bytes = NULL;
+  // Row order and regions were laid out for the old height
+  dev->start_line = 0;
+  dev->fixed_rows = 0;
+  dev->region_count = 0;
+  dev->shadow_valid = false;
+  dev->window_area = 0;
+  reset_dirty(dev);
+  ssd1306_clear(dev);
+
+  uint8_t cmds[] = {
+    SET_MUX_RATIO, (uint8_t)(rows - 1),
+    SET_DISP_OFFSET, offset,
+    SET_DISP_START_LINE,
+  };
+  return write_commands(dev, cmds, sizeof(cmds));
 }
 
 void ssd1306_draw_pixel(ssd1306_t *dev, uint16_t x, uint16_t y) {
@@ -233,108 +2201,249 @@ void ssd1306_draw_rect(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uin
   }
 }
 
-void ssd1306_draw_ellipse(ssd1306_t *dev, int16_t x_center, int16_t y_center,
-                          uint16_t r_horiz, uint16_t r_vert) {
-  // Implements the midpoint ellipse algorithm
-  // See: https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
+static uint8_t clip_box(const ssd1306_t *dev, int32_t x_min, int32_t y_min, int32_t x_max, int32_t y_max) {
+  if (x_max < 0 || y_max < 0 || x_min >= dev->width || y_min >= dev->height) {
+    return CLIP_OUTSIDE;
+  }
+  if (x_min >= 0 && y_min >= 0 && x_max < dev->width && y_max < dev->height) {
+    return CLIP_INSIDE;
+  }
+  return CLIP_PARTIAL;
+}
 
-  if (!r_horiz || !r_vert) {
-    return;
+static inline void plot(ssd1306_t *dev, int32_t x, int32_t y, uint8_t clip) {
+  // Bounds are only checked for the parts of a shape that cross the display edge, and
+  // the changed area was marked once for the whole shape
+  if (clip == CLIP_INSIDE ||
+      (clip == CLIP_PARTIAL && x >= 0 && y >= 0 && x < dev->width && y < dev->height)) {
+    y += dev->start_line;
+    if (y >= dev->height) {
+      y -= dev->height;
+    }
+    dev->buff[x + dev->width * (y >> 3)] |= 0x01u << (y & 7);
   }
-  // Bounding box check
-  if ((x_center + (int16_t)r_horiz) < 0 || (x_center - (int16_t)r_horiz) >= dev->width ||
-      (y_center + (int16_t)r_vert) < 0 || (y_center - (int16_t)r_vert) >= dev->height) {
+}
+
+static void draw_circle(ssd1306_t *dev, int32_t xc, int32_t yc, int32_t r) {
+  if (clip_box(dev, xc - r, yc - r, xc + r, yc + r) == CLIP_OUTSIDE) {
     return;
   }
+  mark_rows_dirty(dev, xc - r, yc - r, xc + r, yc + r);
+  // Each octant covers offsets (x, y) with x <= y, so x stays within [0, r] and y
+  // within [r / 2, r]. Octants are numbered by the signs of x and y, then whether
+  // they are swapped
+  int32_t half = r / 2;
+  uint8_t clip[8] = {
+    clip_box(dev, xc, yc + half, xc + r, yc + r),
+    clip_box(dev, xc + half, yc, xc + r, yc + r),
+    clip_box(dev, xc - r, yc + half, xc, yc + r),
+    clip_box(dev, xc - r, yc, xc - half, yc + r),
+    clip_box(dev, xc, yc - r, xc + r, yc - half),
+    clip_box(dev, xc + half, yc - r, xc + r, yc),
+    clip_box(dev, xc - r, yc - r, xc, yc - half),
+    clip_box(dev, xc - r, yc - r, xc - half, yc),
+  };
+  int32_t x = 0;
+  int32_t y = r;
+  // Midpoint decision for the next column, kept in integers by working with 1 - r
+  // in place of 5/4 - r
+  int32_t d = 1 - r;
 
-  int16_t x = 0;
-  int16_t y = (int16_t) r_vert;
-
-  float rx = (float) r_horiz;
-  float ry = (float) r_vert;
-  float rx2 = rx * rx;
-  float ry2 = ry * ry;
-  float two_rx2 = 2.0f * rx2;
-  float two_ry2 = 2.0f * ry2;
+  while (x <= y) {
+    plot(dev, xc + x, yc + y, clip[0]);
+    plot(dev, xc + y, yc + x, clip[1]);
+    plot(dev, xc - x, yc + y, clip[2]);
+    plot(dev, xc - y, yc + x, clip[3]);
+    plot(dev, xc + x, yc - y, clip[4]);
+    plot(dev, xc + y, yc - x, clip[5]);
+    plot(dev, xc - x, yc - y, clip[6]);
+    plot(dev, xc - y, yc - x, clip[7]);
+    if (d < 0) {
+      d += 2 * x + 3;
+    } else {
+      d += 2 * (x - y) + 5;
+      y--;
+    }
+    x++;
+  }
+}
 
-  float dx = 0.0f;
-  float dy = two_rx2 * (float) y;
-  float d1 = ry2 - (rx2 * ry) + (0.25f * rx2);
+static void ellipse_arcs(ssd1306_t *dev, int32_t xc, int32_t yc, int32_t rx, int32_t ry,
+                         const uint8_t *clip) {
+  int32_t rx2 = rx * rx;
+  int32_t ry2 = ry * ry;
+  int32_t x = 0;
+  int32_t y = ry;
+  int32_t dx = 0;
+  int32_t dy = 2 * rx2 * y;
+  // Decision values are kept four times over so the half-pixel midpoints stay integers
+  int32_t d = 4 * ry2 - 4 * rx2 * ry + rx2;
 
+  // Region 1, where the slope is shallower than -1 and x steps every time
   while (dx <= dy) {
-    draw_pixel(dev, x_center + x, y_center + y, 1);
-    draw_pixel(dev, x_center - x, y_center + y, 1);
-    draw_pixel(dev, x_center + x, y_center - y, 1);
-    draw_pixel(dev, x_center - x, y_center - y, 1);
-
-    if (d1 < 0.0f) {
-      x++;
-      dx += two_ry2;
-      d1 += dx + ry2;
+    plot(dev, xc + x, yc + y, clip[0]);
+    plot(dev, xc - x, yc + y, clip[1]);
+    plot(dev, xc + x, yc - y, clip[2]);
+    plot(dev, xc - x, yc - y, clip[3]);
+    x++;
+    dx += 2 * ry2;
+    if (d < 0) {
+      d += 4 * (dx + ry2);
     } else {
-      x++;
       y--;
-      dx += two_ry2;
-      dy -= two_rx2;
-      d1 += dx - dy + ry2;
+      dy -= 2 * rx2;
+      d += 4 * (dx - dy + ry2);
     }
   }
+  // Move the decision from the midpoint (x + 1, y - 1/2) to (x + 1/2, y - 1)
+  d -= ry2 * (4 * x + 3) + rx2 * (4 * y - 3);
 
-  float d2 = (ry2 * (x + 0.5f) * (x + 0.5f)) +
-             (rx2 * (y - 1.0f) * (y - 1.0f)) -
-             (rx2 * ry2);
-
+  // Region 2, where y steps every time
   while (y >= 0) {
-    draw_pixel(dev, x_center + x, y_center + y, 1);
-    draw_pixel(dev, x_center - x, y_center + y, 1);
-    draw_pixel(dev, x_center + x, y_center - y, 1);
-    draw_pixel(dev, x_center - x, y_center - y, 1);
+    plot(dev, xc + x, yc + y, clip[0]);
+    plot(dev, xc - x, yc + y, clip[1]);
+    plot(dev, xc + x, yc - y, clip[2]);
+    plot(dev, xc - x, yc - y, clip[3]);
+    y--;
+    dy -= 2 * rx2;
+    if (d > 0) {
+      d += 4 * (rx2 - dy);
+    } else {
+      x++;
+      dx += 2 * ry2;
+      d += 4 * (dx - dy + rx2);
+    }
+  }
+}
 
-    if (d2 > 0.0f) {
-      y--;
-      dy -= two_rx2;
-      d2 += rx2 - dy;
+// Same as ellipse_arcs, for radii whose decision terms no longer fit in 32 bits
+static void ellipse_arcs_wide(ssd1306_t *dev, int32_t xc, int32_t yc, int32_t rx, int32_t ry,
+                              const uint8_t *clip) {
+  int64_t rx2 = (int64_t) rx * rx;
+  int64_t ry2 = (int64_t) ry * ry;
+  int32_t x = 0;
+  int32_t y = ry;
+  int64_t dx = 0;
+  int64_t dy = 2 * rx2 * y;
+  int64_t d = 4 * ry2 - 4 * rx2 * ry + rx2;
+
+  // Region 1, where the slope is shallower than -1 and x steps every time
+  while (dx <= dy) {
+    plot(dev, xc + x, yc + y, clip[0]);
+    plot(dev, xc - x, yc + y, clip[1]);
+    plot(dev, xc + x, yc - y, clip[2]);
+    plot(dev, xc - x, yc - y, clip[3]);
+    x++;
+    dx += 2 * ry2;
+    if (d < 0) {
+      d += 4 * (dx + ry2);
     } else {
       y--;
+      dy -= 2 * rx2;
+      d += 4 * (dx - dy + ry2);
+    }
+  }
+  // Move the decision from the midpoint (x + 1, y - 1/2) to (x + 1/2, y - 1)
+  d -= ry2 * (4 * x + 3) + rx2 * (4 * y - 3);
+
+  // Region 2, where y steps every time
+  while (y >= 0) {
+    plot(dev, xc + x, yc + y, clip[0]);
+    plot(dev, xc - x, yc + y, clip[1]);
+    plot(dev, xc + x, yc - y, clip[2]);
+    plot(dev, xc - x, yc - y, clip[3]);
+    y--;
+    dy -= 2 * rx2;
+    if (d > 0) {
+      d += 4 * (rx2 - dy);
+    } else {
       x++;
-      dx += two_ry2;
-      dy -= two_rx2;
-      d2 += dx - dy + rx2;
+      dx += 2 * ry2;
+      d += 4 * (dx - dy + rx2);
     }
   }
 }
 
+void ssd1306_draw_ellipse(ssd1306_t *dev, int16_t x_center, int16_t y_center,
+                          uint16_t r_horiz, uint16_t r_vert) {
+  // Implements the midpoint ellipse algorithm
+  // See: https://en.wikipedia.org/wiki/Midpoint_circle_algorithm
+
+  if (!r_horiz || !r_vert) {
+    return;
+  }
+  if (r_horiz == r_vert) {
+    draw_circle(dev, x_center, y_center, r_horiz);
+    return;
+  }
+  int32_t xc = x_center;
+  int32_t yc = y_center;
+  int32_t rx = r_horiz;
+  int32_t ry = r_vert;
+
+  // Bounding box check
+  if (clip_box(dev, xc - rx, yc - ry, xc + rx, yc + ry) == CLIP_OUTSIDE) {
+    return;
+  }
+  mark_rows_dirty(dev, xc - rx, yc - ry, xc + rx, yc + ry);
+  // Quadrants numbered by the signs of x and y
+  uint8_t clip[4] = {
+    clip_box(dev, xc, yc, xc + rx, yc + ry),
+    clip_box(dev, xc - rx, yc, xc, yc + ry),
+    clip_box(dev, xc, yc - ry, xc + rx, yc),
+    clip_box(dev, xc - rx, yc - ry, xc, yc),
+  };
+  if (rx > MAX_ELLIPSE_RADIUS || ry > MAX_ELLIPSE_RADIUS) {
+    ellipse_arcs_wide(dev, xc, yc, rx, ry, clip);
+  } else {
+    ellipse_arcs(dev, xc, yc, rx, ry, clip);
+  }
+}
+
 void ssd1306_draw_circle(ssd1306_t *dev, int16_t x_center, int16_t y_center, uint16_t r) {
-  ssd1306_draw_ellipse(dev, x_center, y_center, r, r);
+  if (r) {
+    draw_circle(dev, x_center, y_center, r);
+  }
 }
 
 void ssd1306_fill_rect(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height) {
-  fill_rect(dev, x, y, width, height, 1);
+  fill_rect(dev, x, y, width, height, FILL_SET);
 }
 
 void ssd1306_clear_rect(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height) {
-  fill_rect(dev, x, y, width, height, 0);
+  fill_rect(dev, x, y, width, height, FILL_CLEAR);
+}
+
+void ssd1306_invert_rect(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  fill_rect(dev, x, y, width, height, FILL_INVERT);
 }
 
 void ssd1306_draw_str(ssd1306_t *dev, int x, int y, const char *str, const ssd1306_font_t *font) {
-  const uint8_t last = font->first + font->count;
+  draw_str(dev, x, y, str, font, true);
+}
 
-  do {
-    uint8_t ch = (uint8_t) *str;
-    // Skip characters not in the font
-    if (ch < font->first || ch >= last) {
-        x += font->width;
-        continue;
-    }
-    draw_char(dev, x, y, str, font);
-    x += font->width;
-  } while (*(++str));
+void ssd1306_draw_str_transparent(ssd1306_t *dev, int x, int y, const char *str,
+                                  const ssd1306_font_t *font) {
+  draw_str(dev, x, y, str, font, false);
 }
 
 void ssd1306_draw_image(ssd1306_t *dev, uint16_t x, uint16_t y, const ssd1306_image_t *image) {
+  if (image->format == SSD1306_IMAGE_PAGES) {
+    // A page of the image at a time, 8 rows of whole bytes. Callers pass negative
+    // positions wrapped around, as in ssd1306_canvas_draw_image
+    for (uint16_t page = 0; page * 8 < image->height; page++) {
+      uint8_t rows = MIN(image->height - page * 8, 8);
+      blit_columns(dev, (int16_t) x, (int16_t) y + page * 8, image->data + page * image->width,
+                   image->width, rows, true);
+    }
+    return;
+  }
+  // Rows start on a byte boundary, padded to whole bytes
+  size_t stride = (image->width + 7) / 8;
+
   for (uint16_t j = 0; j < image->height; j++) {
     for (uint16_t i = 0; i < image->width; i++) {
-      size_t byte_index = (i + j * image->width) / 8;
+      size_t byte_index = j * stride + i / 8;
       uint8_t bit_index = 7 - (i % 8);
       bool pixel_on = (image->data[byte_index] >> bit_index) & 0x01u;
       draw_pixel(dev, x + i, y + j, pixel_on);
@@ -343,25 +2452,219 @@ void ssd1306_draw_image(ssd1306_t *dev, uint16_t x, uint16_t y, const ssd1306_im
 }
 
 void ssd1306_scroll_horiz(ssd1306_t *dev, bool right, uint8_t start_page, uint8_t end_page, uint8_t speed) {
-  ssd1306_scroll_horiz_stop(dev);
-  write_command(dev, right ? 0x26 : 0x27);
-  write_command(dev, 0x00);
-  write_command(dev, start_page & 0x07);
-  write_command(dev, speed & 0x00);
-  write_command(dev, end_page & 0x07);
-  write_command(dev, 0x00);
-  write_command(dev, 0xFF);
-  write_command(dev, 0x2F);
+  uint8_t cmds[] = {
+    SET_SCROLL_STOP,
+    right ? SET_SCROLL_RIGHT : SET_SCROLL_LEFT,
+    0x00,
+    start_page & 0x07,
+    speed & 0x07,
+    end_page & 0x07,
+    0x00,
+    0xFF,
+    SET_SCROLL_START
+  };
+  // Setting up a scroll needs the one running to be stopped first
+  size_t skip = dev->scrolling ? 0 : 1;
+
+  write_commands(dev, cmds + skip, sizeof(cmds) - skip);
+  dev->scrolling = true;
+}
+
+void ssd1306_scroll_diag(ssd1306_t *dev, bool right, uint8_t start_page, uint8_t end_page, uint8_t speed,
+                         uint8_t fixed_rows, uint8_t scroll_rows, uint8_t vert_offset) {
+  uint8_t cmds[] = {
+    SET_SCROLL_STOP,
+    SET_VERT_SCROLL_AREA,
+    fixed_rows & 0x3F,
+    scroll_rows & 0x7F,
+    right ? SET_SCROLL_VERT_RIGHT : SET_SCROLL_VERT_LEFT,
+    0x00,
+    start_page & 0x07,
+    speed & 0x07,
+    end_page & 0x07,
+    vert_offset & 0x3F,
+    SET_SCROLL_START
+  };
+  size_t skip = dev->scrolling ? 0 : 1;
+
+  write_commands(dev, cmds + skip, sizeof(cmds) - skip);
+  dev->scrolling = true;
+}
+
+static uint8_t ticker_column(const ssd1306_ticker_t *ticker, uint32_t col) {
+  const ssd1306_font_t *font = ticker->font;
+
+  if (col >= ticker->text_cols) {
+    return 0;
+  }
+  uint8_t ch = (uint8_t) ticker->text[col / font->width];
+  // Characters not in the font are left blank, as in ssd1306_draw_str
+  if (ch < font->first || ch >= font->first + font->count) {
+    return 0;
+  }
+  return font->data[(ch - font->first) * font->width + col % font->width];
+}
+
+// Display RAM page showing the ticker's page row. The controller scrolls whole RAM pages,
+// so a start line between page boundaries leaves no page to scroll
+static bool ticker_ram_page(const ssd1306_t *dev, const ssd1306_ticker_t *ticker, uint8_t *page) {
+  if (dev->start_line & 7) {
+    return false;
+  }
+  *page = (ticker->page + (dev->start_line >> 3)) % dev->pages;
+  return true;
+}
+
+bool ssd1306_ticker_start(ssd1306_t *dev, ssd1306_ticker_t *ticker, const char *text,
+                          const ssd1306_font_t *font, uint8_t page, uint16_t cols_per_sec, bool loop) {
+  ticker->text = text;
+  ticker->font = font;
+  ticker->page = page;
+  ticker->loop = loop;
+  ticker->offset = 0;
+  ticker->text_cols = strlen(text) * font->width;
+  ticker->interval_us = MAX(1000000 / MAX(cols_per_sec, 1), MIN_CONTENT_SCROLL_US);
+  ticker->last_step_us = time_us_32() - ticker->interval_us;
+
+  uint8_t ram_page;
+  if (!ticker_ram_page(dev, ticker, &ram_page)) {
+    return false;
+  }
+  // Text enters from the right edge of a blank row
+  memset(dev->buff + ram_page * dev->width, 0, dev->width);
+  return write_window(dev, 0, dev->width - 1, ram_page, ram_page);
+}
+
+bool ssd1306_ticker_step(ssd1306_t *dev, ssd1306_ticker_t *ticker) {
+  // Scrolled until the last column of text has left the screen
+  uint32_t length = ticker->text_cols + dev->width;
+
+  if (ticker->offset == length) {
+    if (!ticker->loop) {
+      return false;
+    }
+    ticker->offset = 0;
+  }
+  uint32_t now = time_us_32();
+  if (now - ticker->last_step_us < ticker->interval_us) {
+    return true;
+  }
+  ticker->last_step_us = now;
+
+  uint8_t page;
+  if (!ticker_ram_page(dev, ticker, &page)) {
+    return false;
+  }
+  // The controller moves the row one column left, only the column exposed on the right
+  // is sent. The frame buffer is moved to match
+  uint8_t *row = dev->buff + page * dev->width;
+  memmove(row, row + 1, dev->width - 1);
+  row[dev->width - 1] = ticker_column(ticker, ticker->offset++);
+
+  uint8_t cmds[7 + MAX_WINDOW_CMDS] = {
+    SET_CONTENT_SCROLL_LEFT, 0x00, page, 0x01, page, 0x00, dev->width - 1
+  };
+  size_t cmd_len = 7 + window_commands(dev, cmds + 7, dev->width - 1, dev->width - 1, page, page);
+
+  if (!write_data(dev, cmds, cmd_len, row + dev->width - 1, 1)) {
+    // Whether the panel scrolled is unknown, the next flush sends the whole row
+    mark_dirty(dev, 0, dev->width - 1, page, page);
+    return false;
+  }
+  sync_shadow(dev, dev->buff, 0, dev->width, page, 1);
+  return true;
 }
 
 void ssd1306_scroll_horiz_stop(ssd1306_t *dev) {
-  write_command(dev, 0x2E);
+  if (dev->scrolling) {
+    write_command(dev, SET_SCROLL_STOP);
+    dev->scrolling = false;
+  }
+}
+
+static uint64_t rotate_rows(uint64_t col, uint16_t by, uint16_t height) {
+  uint64_t mask = height == 64 ? ~0ull : (1ull << height) - 1;
+
+  by %= height;
+  if (by == 0) {
+    return col;
+  }
+  return ((col << by) | (col >> (height - by))) & mask;
+}
+
+void ssd1306_set_fixed_rows(ssd1306_t *dev, uint8_t rows) {
+  dev->fixed_rows = MIN(rows, dev->height);
+}
+
+bool ssd1306_scroll_lines(ssd1306_t *dev, int16_t lines) {
+  uint16_t height = dev->height;
+  uint16_t area = height - dev->fixed_rows;
+
+  if (lines == 0 || area == 0) {
+    return true;
+  }
+  lines = MAX(MIN(lines, (int16_t) area), -(int16_t) area);
+  uint16_t old_start = dev->start_line;
+  uint16_t new_start = (old_start + lines + height) % height;
+  // Scrolling rows of a column, in logical order
+  uint64_t area_mask = (height == 64 ? ~0ull : (1ull << height) - 1) & ~((1ull << dev->fixed_rows) - 1);
+  uint8_t changed_pages = 0;
+
+  // Each column is handled as one word of rows: rotate it to logical order, move the
+  // scrolling rows and rotate it back by the new start line. The fixed rows follow the
+  // start line, the rows scrolled in come out blank
+  for (uint16_t x = 0; x < dev->width; x++) {
+    uint64_t col = 0;
+    for (uint16_t page = 0; page < dev->pages; page++) {
+      col |= (uint64_t) dev->buff[page * dev->width + x] << (page * 8);
+    }
+    uint64_t logical = rotate_rows(col, height - old_start, height);
+    uint64_t moved = lines > 0 ? (logical & area_mask) >> lines : (logical & area_mask) << -lines;
+
+    logical = (logical & ~area_mask) | (moved & area_mask);
+    uint64_t updated = rotate_rows(logical, new_start, height);
+    for (uint16_t page = 0; page < dev->pages; page++) {
+      uint8_t byte = updated >> (page * 8);
+      if (dev->buff[page * dev->width + x] != byte) {
+        dev->buff[page * dev->width + x] = byte;
+        changed_pages |= 1u << page;
+      }
+    }
+  }
+  dev->start_line = new_start;
+  for (uint8_t i = 0; i < dev->region_count; i++) {
+    place_region(dev, &dev->regions[i]);
+  }
+  // The new start line leads the first changed pages in the same transfer, so the panel
+  // never shows them at the old one. Only the pages holding the moved fixed rows and
+  // the new blank rows differ
+  dev->pending |= PENDING_START_LINE;
+  for (uint16_t page = 0; page < dev->pages; page++) {
+    if (changed_pages & (1u << page)) {
+      uint16_t last = page;
+      while (last + 1 < dev->pages && (changed_pages & (1u << (last + 1)))) {
+        last++;
+      }
+      if (!write_window(dev, 0, dev->width - 1, page, last)) {
+        // The rest of the changed pages go out with the next flush
+        mark_dirty(dev, 0, dev->width - 1, page, dev->pages - 1);
+        return false;
+      }
+      page = last;
+    }
+  }
+  if (dev->pending & PENDING_START_LINE) {
+    uint8_t cmds[PENDING_CMDS];
+    return write_commands(dev, cmds, pending_commands(dev, cmds));
+  }
+  return true;
 }
 
 void ssd1306_scroll_row_vert(ssd1306_t *dev, bool down) {
   uint16_t width = dev->width;
   uint16_t pages = dev->height / 8;
 
+  mark_dirty(dev, 0, width - 1, 0, pages - 1);
   // Run through the columns and shift each column's bytes to given direction
   for (uint16_t col = 0; col < width; ++col) {
     uint8_t carry = 0;
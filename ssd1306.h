@@ -5,46 +5,501 @@
  */
 
 #include <pico/stdlib.h>
+#include <pico/mutex.h>
 #include <hardware/i2c.h>
+#include <hardware/spi.h>
 #include "lib/font.h"
 #include "lib/image.h"
 
 #ifndef SSD1306_H
 #define SSD1306_H
 
+struct ssd1306;
+
+// Bytes in front of every frame buffer that transports may use as scratch for headers
+#define SSD1306_DATA_PREFIX 32
+
+// Commands that can travel in front of display data in one transfer
+#define SSD1306_MAX_HEADER_CMDS 15
+
+// Pass as the reset pin when it is not connected
+#define SSD1306_NO_PIN 0xFF
+
+// Called from the DMA interrupt when an asynchronous flush has been handed to the transport
+typedef void (*ssd1306_async_cb_t)(struct ssd1306 *dev, void *user_data);
+
+// Hardware fade effects, see ssd1306_fade
+typedef enum {
+  SSD1306_FADE_OFF = 0x00,
+  // Lower the contrast step by step until the display is dark, then stay dark
+  SSD1306_FADE_OUT = 0x20,
+  // Fade out and back in, repeatedly
+  SSD1306_FADE_BLINK = 0x30,
+} ssd1306_fade_t;
+
+// Called between the slices of a chunked flush, with the bus free for other devices
+typedef void (*ssd1306_yield_cb_t)(struct ssd1306 *dev, void *user_data);
+
+// Bus traffic counters, compare before and after a call to see what it cost
+typedef struct {
+  // Transactions started, an I2C start/address/stop or an SPI chip select
+  uint32_t transactions;
+  // Bytes sent, I2C control bytes included and address bytes excluded
+  uint32_t bytes;
+  // Transfers that failed with a NACK or timeout, those repeated, and bus recoveries
+  uint32_t errors;
+  uint32_t retries;
+  uint32_t recoveries;
+  // Longest blocking transaction, retries included, so the worst flush latency can be checked
+  uint32_t max_txn_us;
+} ssd1306_stats_t;
+
+// Flush scheduler counters, see ssd1306_start_scheduler
+typedef struct {
+  // Calls to ssd1306_request_show, and those merged into a frame that was already pending
+  uint32_t requests;
+  uint32_t coalesced;
+  // Transfers started by the scheduler
+  uint32_t frames;
+  // Time with a transfer in progress, and since the scheduler was started or reset
+  uint32_t busy_us;
+  uint32_t elapsed_us;
+  // Achieved frame rate and share of time the bus was busy, filled in by ssd1306_scheduler_stats
+  uint16_t fps;
+  uint8_t duty_percent;
+} ssd1306_sched_stats_t;
+
+// Areas that can be given their own refresh rate, see ssd1306_add_region
+#define SSD1306_MAX_REGIONS 4
+
+typedef struct {
+  const char *name;
+  // Columns and rows covered
+  uint8_t x_min;
+  uint8_t x_max;
+  uint8_t row_min;
+  uint8_t row_max;
+  // Display RAM pages holding those rows, moved along by ssd1306_scroll_lines
+  uint8_t page_min;
+  uint8_t page_max;
+  // Changed part waiting to be sent, empty when dirty_x_min > dirty_x_max
+  uint8_t dirty_x_min;
+  uint8_t dirty_x_max;
+  uint8_t dirty_page_min;
+  uint8_t dirty_page_max;
+  // Shortest time between flushes, 0 for no limit
+  uint32_t interval_us;
+  uint32_t last_sent_us;
+} ssd1306_region_t;
+
+// What a chunked ssd1306_show costs, in byte times as used for flush planning
+typedef struct {
+  uint16_t slices;
+  // Largest slice, how long another device on the bus may have to wait
+  uint32_t max_slice_cost;
+  // Added compared with sending the frame in one transfer
+  uint32_t overhead;
+} ssd1306_chunk_info_t;
+
+// Text scrolled across one page row by the controller, see ssd1306_ticker_start
+typedef struct {
+  const char *text;
+  const ssd1306_font_t *font;
+  // Page row on screen, counted from the top like drawing coordinates
+  uint8_t page;
+  bool loop;
+  // Columns of text fed in so far, and the width of the whole text
+  uint32_t offset;
+  uint32_t text_cols;
+  uint32_t interval_us;
+  uint32_t last_step_us;
+} ssd1306_ticker_t;
+
+// Columns col_start to col_end (inclusive) of one page
 typedef struct {
+  uint8_t page;
+  uint8_t col_start;
+  uint8_t col_end;
+} ssd1306_span_t;
+
+typedef enum {
+  // Resend the whole frame in one transfer
+  SSD1306_PLAN_FULL,
+  // One horizontal addressing mode window per merged span
+  SSD1306_PLAN_WINDOWS,
+  // Page addressing mode, positioned with the shorter page and column start commands
+  SSD1306_PLAN_PAGES,
+} ssd1306_plan_mode_t;
+
+typedef struct {
+  ssd1306_plan_mode_t mode;
+  // Estimated bus cost in byte times, transaction overhead included
+  uint32_t cost;
+  uint16_t transfers;
+} ssd1306_plan_t;
+
+// How commands and display data reach the controller
+typedef struct {
+  // Send a sequence of command bytes
+  bool (*write_cmd)(struct ssd1306 *dev, const uint8_t *cmds, size_t len);
+  // Send optional commands followed by display data. The SSD1306_DATA_PREFIX bytes
+  // in front of data may be overwritten, the caller restores them
+  bool (*write_data)(struct ssd1306 *dev, const uint8_t *cmds, size_t cmd_len, uint8_t *data, size_t len);
+  // Send display data already led by the 0x40 data control byte, such as a frame in flash.
+  // NULL if unsupported
+  bool (*write_wire)(struct ssd1306 *dev, const uint8_t *data, size_t len);
+  // Same as write_data, but only starts the transfer on dev->dma_chan. NULL if unsupported
+  bool (*write_data_async)(struct ssd1306 *dev, const uint8_t *cmds, size_t cmd_len, uint8_t *data, size_t len);
+  // Called from the DMA interrupt when the asynchronous transfer has been fed, may be NULL
+  void (*async_done)(struct ssd1306 *dev);
+  // Whether the bus is still sending after the DMA has finished, may be NULL
+  bool (*busy)(struct ssd1306 *dev);
+  // Called outside the interrupt once busy is false after an asynchronous transfer, may
+  // be NULL
+  void (*async_finish)(struct ssd1306 *dev);
+  // Bring a hung bus or controller back before the init sequence is sent again, may be NULL
+  bool (*recover)(struct ssd1306 *dev);
+  // Fixed cost of one transfer in byte times, used for flush planning
+  uint8_t txn_overhead;
+  // Bytes on the wire per command byte placed in front of data
+  uint8_t cmd_bytes;
+} ssd1306_transport_t;
+
+// Transport for the I2C interface, uses i2c_inst and i2c_addr
+extern const ssd1306_transport_t ssd1306_i2c_transport;
+
+// Transport for the 4-wire SPI interface, uses spi_inst, pin_dc and pin_cs
+extern const ssd1306_transport_t ssd1306_spi_transport;
+
+typedef struct ssd1306 {
   uint16_t width;
   uint16_t height;
   uint16_t pages;
+  // Rows of the panel itself, height is less while ssd1306_set_rows drives part of it
+  uint16_t panel_height;
+  uint8_t display_offset;
+  // Divide ratio and oscillator frequency as sent with SET_DISP_CLK_DIV
+  uint8_t clock_div;
+  const ssd1306_transport_t *transport;
   uint8_t i2c_addr;
   i2c_inst_t *i2c_inst;
+  spi_inst_t *spi_inst;
+  uint8_t pin_dc;
+  uint8_t pin_cs;
+  uint8_t pin_rst;
+  // I2C pins, needed to free a stuck bus. SSD1306_NO_PIN until ssd1306_set_i2c_pins
+  uint8_t pin_sda;
+  uint8_t pin_scl;
   bool external_vcc;
   uint8_t *buff;
   size_t buff_size;
+  // Bounding box of the frame buffer changed since the last flush, empty when x_min > x_max
+  uint16_t dirty_x_min;
+  uint16_t dirty_x_max;
+  uint16_t dirty_page_min;
+  uint16_t dirty_page_max;
+  // Asynchronous flush state, the DMA channel is claimed on first use (-1 until then)
+  int dma_chan;
+  // Copies of the frame the DMA reads from: I2C data/command words, SPI bytes
+  uint16_t *dma_words;
+  uint8_t *dma_bytes;
+  volatile bool async_busy;
+  // Set from the DMA interrupt until the bytes left in the FIFO have been sent
+  volatile bool async_draining;
+  // Whether the DMA flush in progress holds bus_lock
+  volatile bool async_locked;
+  ssd1306_async_cb_t async_cb;
+  void *async_user_data;
+  // Buffer last handed to the transport in double-buffered mode, NULL otherwise
+  uint8_t *front_buff;
+  bool copy_forward;
+  ssd1306_stats_t stats;
+  // Copy of the last frame sent, used by ssd1306_show_diff
+  uint8_t *shadow;
+  bool shadow_valid;
+  // Controller is in page addressing mode after a page-mode flush
+  bool page_mode;
+  // Flush scheduler state
+  repeating_timer_t sched_timer;
+  bool sched_running;
+  volatile bool show_requested;
+  // Set while a blocking transfer has the bus, the scheduler skips its ticks then
+  volatile bool bus_owned;
+  uint32_t sched_start_us;
+  uint32_t sched_transfer_us;
+  ssd1306_sched_stats_t sched_stats;
+  // Refresh regions and the bus budget they share, in bytes per second (0 for no limit)
+  ssd1306_region_t regions[SSD1306_MAX_REGIONS];
+  uint8_t region_count;
+  uint32_t bus_budget;
+  uint32_t bus_credit;
+  uint32_t bus_credit_us;
+  // Chunked flush, off when chunk_size is 0
+  uint16_t chunk_size;
+  ssd1306_yield_cb_t yield_cb;
+  void *yield_user_data;
+  // Held around every blocking transfer when set
+  mutex_t *bus_lock;
+  // Display RAM row shown at the top. The frame buffer keeps rows in display RAM order,
+  // so row y is drawn at (y + start_line) % height. Rows above fixed_rows don't scroll
+  uint8_t start_line;
+  uint8_t fixed_rows;
+  // Controller settings as last set and the hardware effects running
+  uint8_t contrast;
+  ssd1306_fade_t fade;
+  bool zoom;
+  bool inverted;
+  bool display_on;
+  bool scrolling;
+  // Settings waiting for the next flush when defer_commands is set
+  uint8_t pending;
+  bool defer_commands;
+  // Header of a frame handed to another core by ssd1306_prepare_frame, and whether
+  // ssd1306_send_frame failed to send it
+  uint8_t frame_cmds[SSD1306_MAX_HEADER_CMDS];
+  uint8_t frame_cmd_len;
+  volatile bool frame_failed;
+  // Address window last sent, unknown when window_area is 0. window_fill counts the
+  // bytes written into it, modulo its size
+  uint8_t window_col_start;
+  uint8_t window_col_end;
+  uint8_t window_page_start;
+  uint8_t window_page_end;
+  uint16_t window_area;
+  uint16_t window_fill;
+  // Progress of ssd1306_init_poll, and the time from init to the first frame on the panel
+  uint8_t init_step;
+  uint8_t init_page;
+  uint32_t init_wait_us;
+  uint32_t init_start_us;
+  uint32_t first_pixel_us;
+  // Deadline of one blocking transaction, 0 to size it by the length. Failed transactions
+  // are repeated up to retries times, then the bus is recovered if auto_recover is set
+  uint32_t timeout_us;
+  uint8_t retries;
+  bool auto_recover;
+  bool recovering;
+  // I2C rate chosen by ssd1306_tune_i2c (0 if not tuned), and the failed transfers
+  // after which it steps down, 0 to keep it
+  uint32_t i2c_baud;
+  uint16_t retune_errors;
+  uint16_t tune_errors;
 } ssd1306_t;
 
 // Prepare the controller, allocate the frame buffer, and run the power-on sequence
 bool ssd1306_init(ssd1306_t *dev, uint16_t width, uint16_t height,
                   uint8_t i2c_addr, i2c_inst_t *i2c_inst, bool external_vcc);
 
+// Prepare a display on 4-wire SPI. The SPI block and its SCK/MOSI pins must already be
+// set up. D/C and CS are driven as GPIOs, the reset pin is pulsed unless SSD1306_NO_PIN
+bool ssd1306_init_spi(ssd1306_t *dev, uint16_t width, uint16_t height, spi_inst_t *spi_inst,
+                      uint8_t pin_dc, uint8_t pin_cs, uint8_t pin_rst, bool external_vcc);
+
+// Prepare a display behind any transport, such as a mock for host tests
+bool ssd1306_init_transport(ssd1306_t *dev, uint16_t width, uint16_t height,
+                            const ssd1306_transport_t *transport, bool external_vcc);
+
+// Same as ssd1306_init, but without bus traffic. Call ssd1306_init_poll until it returns
+// true to bring the display up a short transfer at a time. The frame buffer starts blank
+// and can be drawn into meanwhile, it becomes the first frame shown
+bool ssd1306_init_async(ssd1306_t *dev, uint16_t width, uint16_t height,
+                        uint8_t i2c_addr, i2c_inst_t *i2c_inst, bool external_vcc);
+
+// Same as ssd1306_init_transport, but brought up by ssd1306_init_poll
+bool ssd1306_init_transport_async(ssd1306_t *dev, uint16_t width, uint16_t height,
+                                  const ssd1306_transport_t *transport, bool external_vcc);
+
+// Take the next init step, returns true once the display is on. Safe to call from the main
+// loop or an alarm callback. first_pixel_us is set when it completes
+bool ssd1306_init_poll(ssd1306_t *dev);
+
+// Add a second frame buffer so drawing can continue while a frame is transmitted.
+// With copy_forward each new back buffer starts as the frame just sent
+bool ssd1306_enable_double_buffer(ssd1306_t *dev, bool copy_forward);
+
+// Same as ssd1306_init followed by ssd1306_enable_double_buffer
+bool ssd1306_init_double_buffered(ssd1306_t *dev, uint16_t width, uint16_t height, uint8_t i2c_addr,
+                                  i2c_inst_t *i2c_inst, bool external_vcc, bool copy_forward);
+
+// Release the frame buffer and any DMA resources held by the device
+void ssd1306_deinit(ssd1306_t *dev);
+
 // Enter low-power standby mode
 void ssd1306_power_off(ssd1306_t *dev);
 
-// Exit standby and enable panel output
+// Exit standby and enable panel output, along with any contrast or invert changes made
+// while the display was off
 void ssd1306_power_on(ssd1306_t *dev);
 
+// Wake from ssd1306_power_off sending only what changed while asleep: the dirty part of
+// the frame and any contrast or invert changes, which are held back while the display is off
+void ssd1306_resume(ssd1306_t *dev);
+
 // Clear the in-memory frame buffer
 void ssd1306_clear(ssd1306_t *dev);
 
-// Invert display colors if inv is non-zero
+// Invert display colors if inv is non-zero. Nothing is sent if unchanged
 void ssd1306_invert(ssd1306_t *dev, uint8_t inv);
 
-// Flush the frame buffer to the display over I2C
-void ssd1306_show(ssd1306_t *dev);
+// Hold contrast and invert changes back and send them in front of the next flush,
+// in the same transfer. Turning deferring off sends anything still waiting
+void ssd1306_defer_commands(ssd1306_t *dev, bool defer);
+
+// Flush the frame buffer to the display. Returns false if the transfer failed, the
+// frame stays dirty so the next flush sends it again
+bool ssd1306_show(ssd1306_t *dev);
+
+// Start flushing the frame buffer with DMA and return immediately. The DMA reads from a
+// copy, so the buffer may be drawn into as soon as this returns. Returns false if a
+// flush is still in progress, no DMA channel is available or another driver holds the
+// bus lock. The callback is optional
+bool ssd1306_show_async(ssd1306_t *dev, ssd1306_async_cb_t callback, void *user_data);
+
+// Send a prebuilt frame from tools/bmp_to_h.py --frame directly from flash, without
+// touching the frame buffer. Returns false if its size doesn't match the display. The
+// next flush of the frame buffer sends it in full
+bool ssd1306_show_flash(ssd1306_t *dev, const ssd1306_frame_t *frame);
+
+// Full-frame flush split for flush services that send from another core. Call
+// ssd1306_prepare_frame on the drawing core: it takes the address window and any
+// settings waiting to be sent, and counts the frame as flushed. ssd1306_send_frame then
+// sends dev->buff or dev->front_buff from the other core without waiting for async_busy
+// or touching the settings. ssd1306_finish_frame, back on the drawing core, marks a
+// failed frame dirty and recovers the bus like any other failed transfer
+void ssd1306_prepare_frame(ssd1306_t *dev);
+bool ssd1306_send_frame(ssd1306_t *dev, uint8_t *frame);
+void ssd1306_finish_frame(ssd1306_t *dev);
 
-// Set contrast (brightness) to a value between 0 and 255
+// Check whether an asynchronous flush is still being transmitted. The bus lock and, on
+// SPI, chip select are released by the first call that finds the transfer complete
+bool ssd1306_async_busy(ssd1306_t *dev);
+
+// Block until any asynchronous flush has been transmitted
+void ssd1306_async_wait(ssd1306_t *dev);
+
+// Hand the drawn back buffer to the transport and continue drawing into the other one.
+// Waits for the previous frame to finish. Same as ssd1306_show when not double-buffered
+bool ssd1306_swap(ssd1306_t *dev);
+
+// Flush only the columns and pages changed since the last flush
+bool ssd1306_show_dirty(ssd1306_t *dev);
+
+// Keep a copy of the last frame sent so ssd1306_show_diff can find what changed
+bool ssd1306_enable_shadow(ssd1306_t *dev);
+
+// Compare the frame buffer with the last frame sent and flush only the changed runs
+// of each page. Falls back to ssd1306_show until a shadow copy is in sync
+bool ssd1306_show_diff(ssd1306_t *dev);
+
+// Work out the cheapest way to send the given spans, which must be sorted by page and column
+ssd1306_plan_t ssd1306_plan_spans(const ssd1306_t *dev, const ssd1306_span_t *spans, size_t count);
+
+// Send the given spans of the frame buffer using the cheapest plan
+bool ssd1306_show_spans(ssd1306_t *dev, const ssd1306_span_t *spans, size_t count);
+
+// Flush the frame buffer from a timer interrupt at most fps times per second, whenever
+// ssd1306_request_show was called since the last frame. Needs a transport with DMA
+// support. The current frame is sent before this returns. While the scheduler runs,
+// use ssd1306_request_show instead of the other flush functions
+bool ssd1306_start_scheduler(ssd1306_t *dev, uint16_t fps);
+
+// Stop the scheduler and wait for the transfer in progress, pending requests are dropped
+void ssd1306_stop_scheduler(ssd1306_t *dev);
+
+// Ask the scheduler to send the frame buffer on its next tick. Requests made before then,
+// including while a transfer is running, are merged into that one frame
+void ssd1306_request_show(ssd1306_t *dev);
+
+// Scheduler counters with the frame rate and bus duty cycle worked out
+ssd1306_sched_stats_t ssd1306_scheduler_stats(ssd1306_t *dev);
+
+// Zero the scheduler counters
+void ssd1306_reset_scheduler_stats(ssd1306_t *dev);
+
+// Register a named area flushed at most max_hz times per second by ssd1306_show_regions,
+// 0 for no limit. Rows are rounded out to whole pages. Returns the region index, or -1
+// if all SSD1306_MAX_REGIONS are in use or the area is off screen. The name is not copied
+int ssd1306_add_region(ssd1306_t *dev, const char *name, int16_t x, int16_t y,
+                       uint16_t width, uint16_t height, uint16_t max_hz);
+
+// Look up a region by name, NULL if there is none
+ssd1306_region_t *ssd1306_find_region(ssd1306_t *dev, const char *name);
+
+// Cap the bytes per second ssd1306_show_regions may put on the bus, 0 for no limit
+void ssd1306_set_bus_budget(ssd1306_t *dev, uint32_t bytes_per_sec);
+
+// Hand the changes since the last flush to the regions that cover them, in the order the
+// regions were added, and send each changed region that is due and fits the bus budget.
+// Changes outside every region are dropped, cover the rest with a slow region. Call often
+void ssd1306_show_regions(ssd1306_t *dev);
+
+// Make ssd1306_show send the frame in slices of at most chunk_bytes of display data, each
+// with its own address window. A chunk of at least the display width sends whole pages.
+// The yield callback, if set, runs between slices. 0 turns chunking off
+void ssd1306_set_chunking(ssd1306_t *dev, uint16_t chunk_bytes, ssd1306_yield_cb_t yield, void *user_data);
+
+// Hold a mutex shared with other drivers on the same bus around each transfer, so they
+// can get in between slices of a chunked flush. DMA flushes take it when they start and
+// release it once the transfer has completed, they don't start while another driver
+// holds it and the flush scheduler tries again on its next tick. NULL for none
+void ssd1306_set_bus_lock(ssd1306_t *dev, mutex_t *lock);
+
+// Slice count, largest slice and added overhead of the next ssd1306_show with the current
+// chunking. Window commands are priced as sent, leaving out those the last window makes
+// unnecessary. Settings waiting to be sent are not included
+ssd1306_chunk_info_t ssd1306_chunk_info(const ssd1306_t *dev);
+
+// Mark an area as changed, for code that writes to the frame buffer directly
+void ssd1306_mark_dirty(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+// Zero the bus traffic counters
+void ssd1306_reset_stats(ssd1306_t *dev);
+
+// Set the deadline of one blocking transaction (0 to size it by its length) and how
+// many times a failed one is repeated. Every flush is then bounded by
+// (retries + 1) * timeout per transfer, see stats.max_txn_us
+void ssd1306_set_timeout(ssd1306_t *dev, uint32_t timeout_us, uint8_t retries);
+
+// Let ssd1306_recover free a stuck bus by clocking SCL. The pins are left on the I2C function
+void ssd1306_set_i2c_pins(ssd1306_t *dev, uint8_t pin_sda, uint8_t pin_scl);
+
+// Free the bus, run the init sequence again and restore the settings in use. The whole
+// frame is sent by the next flush. Runs by itself after a failed transfer unless
+// auto_recover is cleared
+bool ssd1306_recover(ssd1306_t *dev);
+
+// Find the fastest reliable I2C rate: step up from 100 kHz to max_baud sending the frame
+// buffer frames times at each rate, stop at the first NACK or timeout and keep the last
+// rate that passed less a safety margin. The rate is set and returned, 0 if even 100 kHz
+// failed or the display isn't on I2C. After retune_errors failed transfers (0 for never)
+// the rate drops by one step, call again to climb back
+uint32_t ssd1306_tune_i2c(ssd1306_t *dev, uint32_t max_baud, uint8_t frames, uint16_t retune_errors);
+
+// Set contrast (brightness) to a value between 0 and 255. Nothing is sent if unchanged
 void ssd1306_contrast(ssd1306_t *p, uint8_t val);
 
+// Start a hardware fade out or blink, run by the controller with no further traffic.
+// The contrast changes one step every 8 * (interval + 1) frames, interval is 0-15
+void ssd1306_fade(ssd1306_t *dev, ssd1306_fade_t mode, uint8_t interval);
+
+// Show the top half of the display at double height. Returns false on panels with
+// sequential COM pins (128x32), which can't zoom
+bool ssd1306_zoom(ssd1306_t *dev, bool enable);
+
+// Stop fade, blink and zoom, and restore the contrast set before fading
+void ssd1306_effects_stop(ssd1306_t *dev);
+
+// Set the display clock: divide ratio 1-16 and oscillator frequency 0-15 (8 by default).
+// The panel refreshes at oscillator / (divide * rows * clocks per row), so a faster
+// clock or fewer rows raise the refresh rate. Returns false if out of range
+bool ssd1306_set_clock(ssd1306_t *dev, uint8_t divide, uint8_t osc_freq);
+
+// Drive only rows rows of the panel, a multiple of 8 from 16 up to its height, shifted
+// down by offset COM lines. Height, pages and buff_size shrink to match, so every flush
+// sends less. The frame buffer is cleared, scroll state and regions are reset. Call with
+// the panel height and offset 0 to go back to the full display
+bool ssd1306_set_rows(ssd1306_t *dev, uint8_t rows, uint8_t offset);
+
 // Set a single pixel in the frame buffer
 void ssd1306_draw_pixel(ssd1306_t *dev, uint16_t x, uint16_t y);
 
@@ -69,19 +524,58 @@ void ssd1306_fill_rect(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uin
 // Clear an axis-aligned rectangle
 void ssd1306_clear_rect(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height);
 
+// Flip every pixel of an axis-aligned rectangle, such as a highlighted menu entry
+void ssd1306_invert_rect(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height);
+
 // Render a null-terminated string using the supplied bitmap font
 void ssd1306_draw_str(ssd1306_t *display, int x, int y, const char *text, const ssd1306_font_t *font);
 
+// Same as ssd1306_draw_str, but only sets the glyph pixels and leaves the background as it is
+void ssd1306_draw_str_transparent(ssd1306_t *dev, int x, int y, const char *text,
+                                  const ssd1306_font_t *font);
+
 // Copy a monochrome bitmap into the frame buffer
 void ssd1306_draw_image(ssd1306_t *dev, uint16_t x, uint16_t y, const ssd1306_image_t *image);
 
-// Start horizontal scroll effect across a page range
+// Start horizontal scroll effect across a page range. Speed 0-7 selects the frames
+// between steps: 5, 64, 128, 256, 3, 4, 25 or 2
 void ssd1306_scroll_horiz(ssd1306_t *dev, bool right, uint8_t start_page, uint8_t end_page, uint8_t speed);
 
+// Start horizontal scroll across a page range combined with vertical scroll of rows
+// fixed_rows to fixed_rows + scroll_rows - 1, moving vert_offset rows per step
+void ssd1306_scroll_diag(ssd1306_t *dev, bool right, uint8_t start_page, uint8_t end_page, uint8_t speed,
+                         uint8_t fixed_rows, uint8_t scroll_rows, uint8_t vert_offset);
+
+// Scroll text from right to left across a page row with the controller's content scroll,
+// sending one new column per step at up to cols_per_sec (limited to 50). The font must be
+// at most 8 pixels high. Clears the row, the text is not copied. Returns false if the row
+// couldn't be cleared or the start line set by ssd1306_scroll_lines isn't a multiple of 8.
+// Content scroll (0x2C/0x2D) moves the page by one column per command. It is not in the
+// base SSD1306 command table, but later SSD1306 revisions and compatible controllers
+// have it. The continuous scroll (0x26/0x27) of ssd1306_scroll_horiz can't be used,
+// since the controller doesn't allow display RAM writes while it runs
+bool ssd1306_ticker_start(ssd1306_t *dev, ssd1306_ticker_t *ticker, const char *text,
+                          const ssd1306_font_t *font, uint8_t page, uint16_t cols_per_sec, bool loop);
+
+// Take the next ticker step if it is due, call often. Returns false once the text has
+// scrolled off a ticker that doesn't loop, or if the step couldn't be sent. The row is
+// then marked dirty
+bool ssd1306_ticker_step(ssd1306_t *dev, ssd1306_ticker_t *ticker);
+
 // Halt any active horizontal scroll
 void ssd1306_scroll_horiz_stop(ssd1306_t *dev);
 
 // Scroll vertically by one position
 void ssd1306_scroll_row_vert(ssd1306_t *dev, bool down);
 
+// Keep the given number of rows at the top in place when scrolling with ssd1306_scroll_lines
+void ssd1306_set_fixed_rows(ssd1306_t *dev, uint8_t rows);
+
+// Scroll the rows below the fixed rows up (positive) or down (negative) by moving the
+// display start line. The rows scrolled in are blank, draw into them and flush with
+// ssd1306_show_dirty. Only the pages holding the fixed rows and the new rows are sent,
+// the first of them carrying the new start line. Returns false if a transfer failed, the
+// pages not sent stay dirty
+bool ssd1306_scroll_lines(ssd1306_t *dev, int16_t lines);
+
 #endif // SSD1306_H
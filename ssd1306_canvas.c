@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#include <string.h>
+#include "ssd1306_canvas.h"
+
+static const void *panel_bus(const ssd1306_t *panel) {
+  // Panels sharing a bus have to take turns, panels on separate buses can send together
+  if (panel->transport == &ssd1306_spi_transport) {
+    return panel->spi_inst;
+  }
+  return panel->i2c_inst;
+}
+
+static bool overlaps(const ssd1306_canvas_t *canvas, uint8_t i, int32_t x_min, int32_t y_min,
+                     int32_t x_max, int32_t y_max) {
+  const ssd1306_t *panel = canvas->panels[i];
+
+  return x_max >= canvas->x[i] && x_min < canvas->x[i] + panel->width &&
+         y_max >= canvas->y[i] && y_min < canvas->y[i] + panel->height;
+}
+
+void ssd1306_canvas_init(ssd1306_canvas_t *canvas) {
+  memset(canvas, 0, sizeof(*canvas));
+}
+
+bool ssd1306_canvas_add(ssd1306_canvas_t *canvas, ssd1306_t *panel, int16_t x, int16_t y) {
+  if (canvas->count == SSD1306_CANVAS_MAX_PANELS) {
+    return false;
+  }
+  uint8_t i = canvas->count++;
+  canvas->panels[i] = panel;
+  canvas->x[i] = x;
+  canvas->y[i] = y;
+  canvas->queued[i] = false;
+  if (x + panel->width > canvas->width) {
+    canvas->width = x + panel->width;
+  }
+  if (y + panel->height > canvas->height) {
+    canvas->height = y + panel->height;
+  }
+  return true;
+}
+
+static bool bus_free(const ssd1306_canvas_t *canvas, uint8_t i) {
+  for (uint8_t j = 0; j < canvas->count; j++) {
+    if (j != i && panel_bus(canvas->panels[j]) == panel_bus(canvas->panels[i]) &&
+        ssd1306_async_busy(canvas->panels[j])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void start_queued(ssd1306_canvas_t *canvas) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (!canvas->queued[i] || !bus_free(canvas, i)) {
+      continue;
+    }
+    canvas->queued[i] = false;
+    if (!ssd1306_show_async(canvas->panels[i], NULL, NULL)) {
+      // No DMA channel left for this panel, send it the blocking way
+      ssd1306_show(canvas->panels[i]);
+    }
+  }
+}
+
+void ssd1306_canvas_show(ssd1306_canvas_t *canvas) {
+  ssd1306_canvas_wait(canvas);
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    canvas->queued[i] = true;
+  }
+  start_queued(canvas);
+}
+
+bool ssd1306_canvas_busy(ssd1306_canvas_t *canvas) {
+  bool busy = false;
+
+  start_queued(canvas);
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    busy |= canvas->queued[i] || ssd1306_async_busy(canvas->panels[i]);
+  }
+  return busy;
+}
+
+void ssd1306_canvas_wait(ssd1306_canvas_t *canvas) {
+  while (ssd1306_canvas_busy(canvas)) {
+    tight_loop_contents();
+  }
+}
+
+void ssd1306_canvas_clear(ssd1306_canvas_t *canvas) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    ssd1306_clear(canvas->panels[i]);
+  }
+}
+
+static void set_pixel(ssd1306_canvas_t *canvas, int16_t x, int16_t y, bool color) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (overlaps(canvas, i, x, y, x, y)) {
+      if (color) {
+        ssd1306_draw_pixel(canvas->panels[i], x - canvas->x[i], y - canvas->y[i]);
+      } else {
+        ssd1306_clear_pixel(canvas->panels[i], x - canvas->x[i], y - canvas->y[i]);
+      }
+    }
+  }
+}
+
+void ssd1306_canvas_draw_pixel(ssd1306_canvas_t *canvas, int16_t x, int16_t y) {
+  set_pixel(canvas, x, y, true);
+}
+
+void ssd1306_canvas_clear_pixel(ssd1306_canvas_t *canvas, int16_t x, int16_t y) {
+  set_pixel(canvas, x, y, false);
+}
+
+void ssd1306_canvas_draw_line(ssd1306_canvas_t *canvas, int16_t x1, int16_t y1, int16_t x2, int16_t y2) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (overlaps(canvas, i, MIN(x1, x2), MIN(y1, y2), MAX(x1, x2), MAX(y1, y2))) {
+      // Off-panel coordinates wrap around in uint16_t, the line steps stay the same
+      // and the panel clips the pixels that fall outside it
+      ssd1306_draw_line(canvas->panels[i],
+                        (uint16_t)(x1 - canvas->x[i]), (uint16_t)(y1 - canvas->y[i]),
+                        (uint16_t)(x2 - canvas->x[i]), (uint16_t)(y2 - canvas->y[i]));
+    }
+  }
+}
+
+void ssd1306_canvas_draw_rect(ssd1306_canvas_t *canvas, int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (overlaps(canvas, i, x, y, x + width - 1, y + height - 1)) {
+      ssd1306_draw_rect(canvas->panels[i], x - canvas->x[i], y - canvas->y[i], width, height);
+    }
+  }
+}
+
+void ssd1306_canvas_fill_rect(ssd1306_canvas_t *canvas, int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (overlaps(canvas, i, x, y, x + width - 1, y + height - 1)) {
+      ssd1306_fill_rect(canvas->panels[i], x - canvas->x[i], y - canvas->y[i], width, height);
+    }
+  }
+}
+
+void ssd1306_canvas_clear_rect(ssd1306_canvas_t *canvas, int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (overlaps(canvas, i, x, y, x + width - 1, y + height - 1)) {
+      ssd1306_clear_rect(canvas->panels[i], x - canvas->x[i], y - canvas->y[i], width, height);
+    }
+  }
+}
+
+void ssd1306_canvas_draw_ellipse(ssd1306_canvas_t *canvas, int16_t x_center, int16_t y_center,
+                                 uint16_t r_horiz, uint16_t r_vert) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (overlaps(canvas, i, x_center - r_horiz, y_center - r_vert, x_center + r_horiz, y_center + r_vert)) {
+      ssd1306_draw_ellipse(canvas->panels[i], x_center - canvas->x[i], y_center - canvas->y[i], r_horiz, r_vert);
+    }
+  }
+}
+
+void ssd1306_canvas_draw_circle(ssd1306_canvas_t *canvas, int16_t x_center, int16_t y_center, uint16_t r) {
+  ssd1306_canvas_draw_ellipse(canvas, x_center, y_center, r, r);
+}
+
+void ssd1306_canvas_draw_str(ssd1306_canvas_t *canvas, int x, int y, const char *text, const ssd1306_font_t *font) {
+  int32_t x_max = x + (int32_t) strlen(text) * font->width - 1;
+
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (overlaps(canvas, i, x, y, x_max, y + font->height - 1)) {
+      ssd1306_draw_str(canvas->panels[i], x - canvas->x[i], y - canvas->y[i], text, font);
+    }
+  }
+}
+
+void ssd1306_canvas_draw_image(ssd1306_canvas_t *canvas, int16_t x, int16_t y, const ssd1306_image_t *image) {
+  for (uint8_t i = 0; i < canvas->count; i++) {
+    if (overlaps(canvas, i, x, y, x + image->width - 1, y + image->height - 1)) {
+      // Negative offsets wrap around in uint16_t and are clipped by the panel
+      ssd1306_draw_image(canvas->panels[i], (uint16_t)(x - canvas->x[i]), (uint16_t)(y - canvas->y[i]), image);
+    }
+  }
+}
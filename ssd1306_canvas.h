@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#include <pico/stdlib.h>
+#include "ssd1306.h"
+
+#ifndef SSD1306_CANVAS_H
+#define SSD1306_CANVAS_H
+
+#define SSD1306_CANVAS_MAX_PANELS 4
+
+// A drawing surface spanning several physical panels, each an initialized ssd1306_t
+typedef struct {
+  ssd1306_t *panels[SSD1306_CANVAS_MAX_PANELS];
+  // Position of each panel's top-left pixel on the canvas
+  int16_t x[SSD1306_CANVAS_MAX_PANELS];
+  int16_t y[SSD1306_CANVAS_MAX_PANELS];
+  // Panels still waiting for their bus to be free during a flush
+  bool queued[SSD1306_CANVAS_MAX_PANELS];
+  uint8_t count;
+  uint16_t width;
+  uint16_t height;
+} ssd1306_canvas_t;
+
+// Start with an empty canvas
+void ssd1306_canvas_init(ssd1306_canvas_t *canvas);
+
+// Place a panel with its top-left pixel at the given canvas position
+bool ssd1306_canvas_add(ssd1306_canvas_t *canvas, ssd1306_t *panel, int16_t x, int16_t y);
+
+// Start flushing all panels. Panels on separate buses are sent at the same time, panels
+// sharing a bus one after another. Don't draw until ssd1306_canvas_busy returns false
+void ssd1306_canvas_show(ssd1306_canvas_t *canvas);
+
+// Check whether a flush is still in progress, starting queued panels whose bus is free
+bool ssd1306_canvas_busy(ssd1306_canvas_t *canvas);
+
+// Block until all panels have been flushed
+void ssd1306_canvas_wait(ssd1306_canvas_t *canvas);
+
+// Clear the frame buffers of all panels
+void ssd1306_canvas_clear(ssd1306_canvas_t *canvas);
+
+// Set a single pixel
+void ssd1306_canvas_draw_pixel(ssd1306_canvas_t *canvas, int16_t x, int16_t y);
+
+// Clear a single pixel
+void ssd1306_canvas_clear_pixel(ssd1306_canvas_t *canvas, int16_t x, int16_t y);
+
+// Draw a straight line
+void ssd1306_canvas_draw_line(ssd1306_canvas_t *canvas, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
+// Outline an axis-aligned rectangle
+void ssd1306_canvas_draw_rect(ssd1306_canvas_t *canvas, int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+// Fill an axis-aligned rectangle
+void ssd1306_canvas_fill_rect(ssd1306_canvas_t *canvas, int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+// Clear an axis-aligned rectangle
+void ssd1306_canvas_clear_rect(ssd1306_canvas_t *canvas, int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+// Outline an ellipse centered at the given coordinates
+void ssd1306_canvas_draw_ellipse(ssd1306_canvas_t *canvas, int16_t x_center, int16_t y_center,
+                                 uint16_t r_horiz, uint16_t r_vert);
+
+// Outline a circle at the given coordinates
+void ssd1306_canvas_draw_circle(ssd1306_canvas_t *canvas, int16_t x_center, int16_t y_center, uint16_t r);
+
+// Render a null-terminated string using the supplied bitmap font
+void ssd1306_canvas_draw_str(ssd1306_canvas_t *canvas, int x, int y, const char *text, const ssd1306_font_t *font);
+
+// Copy a monochrome bitmap onto the canvas
+void ssd1306_canvas_draw_image(ssd1306_canvas_t *canvas, int16_t x, int16_t y, const ssd1306_image_t *image);
+
+#endif // SSD1306_CANVAS_H
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#include <string.h>
+#include <pico/multicore.h>
+#include "ssd1306_worker.h"
+
+static bool running;
+// Written by core0 only
+static uint8_t queue_depth;
+static uint8_t max_queue_depth;
+static uint32_t core0_stall_us;
+// Written by core1 only
+static volatile uint32_t frames;
+static volatile uint32_t core1_idle_us;
+static volatile uint32_t core1_busy_us;
+
+static void worker_main(void) {
+  while (true) {
+    uint32_t t0 = time_us_32();
+    ssd1306_t *dev = (ssd1306_t *)(uintptr_t)multicore_fifo_pop_blocking();
+    uint32_t t1 = time_us_32();
+
+    // Core0 doesn't touch the frame or swap buffers until async_busy is cleared. The
+    // settings were taken by ssd1306_prepare_frame, core0 may change them meanwhile
+    ssd1306_send_frame(dev, dev->front_buff ? dev->front_buff : dev->buff);
+    core1_idle_us += t1 - t0;
+    core1_busy_us += time_us_32() - t1;
+    frames++;
+    dev->async_busy = false;
+    // Never blocks, at most SSD1306_WORKER_MAX_QUEUE frames are ever outstanding
+    multicore_fifo_push_blocking((uint32_t)(uintptr_t)dev);
+  }
+}
+
+void ssd1306_worker_start(void) {
+  if (running) {
+    return;
+  }
+  multicore_fifo_drain();
+  multicore_launch_core1(worker_main);
+  running = true;
+}
+
+uint8_t ssd1306_worker_poll(void) {
+  while (multicore_fifo_rvalid()) {
+    ssd1306_t *dev = (ssd1306_t *)(uintptr_t)multicore_fifo_pop_blocking();
+
+    queue_depth--;
+    ssd1306_finish_frame(dev);
+    if (dev->async_cb) {
+      dev->async_cb(dev, dev->async_user_data);
+    }
+  }
+  return queue_depth;
+}
+
+bool ssd1306_worker_submit(ssd1306_t *dev) {
+  if (!running) {
+    return false;
+  }
+  uint32_t start = time_us_32();
+
+  ssd1306_worker_poll();
+  while (ssd1306_async_busy(dev) || queue_depth >= SSD1306_WORKER_MAX_QUEUE) {
+    ssd1306_worker_poll();
+  }
+  core0_stall_us += time_us_32() - start;
+
+  if (dev->front_buff) {
+    uint8_t *frame = dev->buff;
+    dev->buff = dev->front_buff;
+    dev->front_buff = frame;
+    if (dev->copy_forward) {
+      memcpy(dev->buff, frame, dev->buff_size);
+    }
+  }
+  ssd1306_prepare_frame(dev);
+  if (dev->front_buff && !dev->copy_forward) {
+    // The new back buffer still holds the frame from two submits ago
+    ssd1306_mark_dirty(dev, 0, 0, dev->width, dev->height);
+  }
+
+  dev->async_busy = true;
+  queue_depth++;
+  max_queue_depth = MAX(max_queue_depth, queue_depth);
+  multicore_fifo_push_blocking((uint32_t)(uintptr_t)dev);
+  return true;
+}
+
+ssd1306_worker_stats_t ssd1306_worker_stats(void) {
+  ssd1306_worker_stats_t stats = {
+    .frames = frames,
+    .queue_depth = queue_depth,
+    .max_queue_depth = max_queue_depth,
+    .core0_stall_us = core0_stall_us,
+    .core1_idle_us = core1_idle_us,
+    .core1_busy_us = core1_busy_us,
+  };
+  return stats;
+}
+
+void ssd1306_worker_reset_stats(void) {
+  // The queue depth is live state, only its high-water mark is reset
+  max_queue_depth = queue_depth;
+  core0_stall_us = 0;
+  frames = 0;
+  core1_idle_us = 0;
+  core1_busy_us = 0;
+}
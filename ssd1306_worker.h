@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#include <pico/stdlib.h>
+#include "ssd1306.h"
+
+#ifndef SSD1306_WORKER_H
+#define SSD1306_WORKER_H
+
+// Frames that may be waiting for or inside the worker, the depth of the inter-core FIFO
+#define SSD1306_WORKER_MAX_QUEUE 8
+
+typedef struct {
+  // Frames sent by the worker
+  uint32_t frames;
+  // Frames submitted but not yet handed back, and the highest it has been
+  uint8_t queue_depth;
+  uint8_t max_queue_depth;
+  // Time core0 spent waiting in ssd1306_worker_submit for the worker to catch up
+  uint32_t core0_stall_us;
+  // Time core1 spent waiting for a frame and sending one
+  uint32_t core1_idle_us;
+  uint32_t core1_busy_us;
+} ssd1306_worker_stats_t;
+
+// Launch the flush worker on core1. It takes over the inter-core FIFO, so don't use
+// it for anything else (multicore_lockout included) while the worker runs
+void ssd1306_worker_start(void);
+
+// Hand the frame buffer to core1 to be sent and return once it has been queued. Waits
+// while this display still has a frame in flight or the queue is full. Double-buffered
+// displays swap buffers like ssd1306_swap, otherwise wait with ssd1306_async_wait before
+// drawing again. The async callback, if set, is called from ssd1306_worker_poll
+bool ssd1306_worker_submit(ssd1306_t *dev);
+
+// Collect frames the worker has handed back and return how many are still queued
+uint8_t ssd1306_worker_poll(void);
+
+// Copy of the worker counters
+ssd1306_worker_stats_t ssd1306_worker_stats(void);
+
+// Zero the worker counters
+void ssd1306_worker_reset_stats(void);
+
+#endif // SSD1306_WORKER_H
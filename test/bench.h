@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Host benchmarks time a drawing workload against the per-pixel code it replaced, written
+// here with ssd1306_draw_pixel and ssd1306_clear_pixel. Host numbers only show the ratio,
+// the RP2040 is much slower at both
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "mock_transport.h"
+
+typedef void (*bench_fn_t)(ssd1306_t *dev);
+
+// Average wall time of one call in microseconds
+static inline double bench_us(bench_fn_t fn, ssd1306_t *dev, int iterations) {
+  struct timespec start, end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int i = 0; i < iterations; i++) {
+    fn(dev);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / iterations / 1000.0;
+}
+
+// Run both workloads once on a cleared buffer and count the bytes where they differ,
+// then time them
+static inline int bench_compare(const char *name, bench_fn_t before, bench_fn_t after, int iterations) {
+  ssd1306_t dev;
+  mock_panel_reset();
+  if (!ssd1306_init_transport(&dev, 128, 64, &mock_transport, false)) {
+    return 1;
+  }
+  uint8_t expected[128 * 64 / 8];
+
+  ssd1306_clear(&dev);
+  before(&dev);
+  memcpy(expected, dev.buff, dev.buff_size);
+  ssd1306_clear(&dev);
+  after(&dev);
+  int differ = 0;
+  for (size_t i = 0; i < dev.buff_size; i++) {
+    differ += expected[i] != dev.buff[i];
+  }
+
+  double before_us = bench_us(before, &dev, iterations);
+  double after_us = bench_us(after, &dev, iterations);
+  printf("%s: %.2f us before, %.2f us after, %.1fx faster, %d bytes differ\n",
+         name, before_us, after_us, before_us / after_us, differ);
+  ssd1306_deinit(&dev);
+  return differ;
+}
+
+#endif
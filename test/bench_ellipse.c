@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Ellipses and circles as drawn by demo_ellipses in example.c, against the
+// float midpoint version they replaced. Circles can round a pixel differently,
+// so differing bytes are reported but don't fail the run
+
+#include "bench.h"
+
+typedef void (*ellipse_fn_t)(ssd1306_t *dev, int16_t x_center, int16_t y_center, uint16_t r_horiz, uint16_t r_vert);
+typedef void (*circle_fn_t)(ssd1306_t *dev, int16_t x_center, int16_t y_center, uint16_t r);
+
+static void plot4(ssd1306_t *dev, int16_t x_center, int16_t y_center, int16_t x, int16_t y) {
+  ssd1306_draw_pixel(dev, x_center + x, y_center + y);
+  ssd1306_draw_pixel(dev, x_center - x, y_center + y);
+  ssd1306_draw_pixel(dev, x_center + x, y_center - y);
+  ssd1306_draw_pixel(dev, x_center - x, y_center - y);
+}
+
+static void draw_ellipse_float(ssd1306_t *dev, int16_t x_center, int16_t y_center, uint16_t r_horiz, uint16_t r_vert) {
+  if (!r_horiz || !r_vert) {
+    return;
+  }
+  if ((x_center + (int16_t) r_horiz) < 0 || (x_center - (int16_t) r_horiz) >= dev->width ||
+      (y_center + (int16_t) r_vert) < 0 || (y_center - (int16_t) r_vert) >= dev->height) {
+    return;
+  }
+  int16_t x = 0;
+  int16_t y = (int16_t) r_vert;
+  float rx2 = (float) r_horiz * r_horiz;
+  float ry2 = (float) r_vert * r_vert;
+  float dx = 0.0f;
+  float dy = 2.0f * rx2 * y;
+  float d1 = ry2 - (rx2 * r_vert) + (0.25f * rx2);
+
+  while (dx <= dy) {
+    plot4(dev, x_center, y_center, x, y);
+    x++;
+    dx += 2.0f * ry2;
+    if (d1 < 0.0f) {
+      d1 += dx + ry2;
+    } else {
+      y--;
+      dy -= 2.0f * rx2;
+      d1 += dx - dy + ry2;
+    }
+  }
+
+  float d2 = (ry2 * (x + 0.5f) * (x + 0.5f)) + (rx2 * (y - 1.0f) * (y - 1.0f)) - (rx2 * ry2);
+
+  while (y >= 0) {
+    plot4(dev, x_center, y_center, x, y);
+    y--;
+    dy -= 2.0f * rx2;
+    if (d2 > 0.0f) {
+      d2 += rx2 - dy;
+    } else {
+      x++;
+      dx += 2.0f * ry2;
+      d2 += dx - dy + rx2;
+    }
+  }
+}
+
+static void draw_circle_float(ssd1306_t *dev, int16_t x_center, int16_t y_center, uint16_t r) {
+  draw_ellipse_float(dev, x_center, y_center, r, r);
+}
+
+static void demo_ellipses(ssd1306_t *dev, ellipse_fn_t ellipse, circle_fn_t circle) {
+  int16_t x_cent = dev->width / 2;
+  int16_t y_cent = dev->height / 2;
+
+  for (uint16_t i = 0; i < 20; i++) {
+    ssd1306_clear(dev);
+    uint16_t wt = i;
+    uint16_t ht = i / 4;
+
+    for (uint16_t r = 0; r < (dev->width * 2); r += 20) {
+      ellipse(dev, -20, y_cent - 10, wt, ht);
+      ellipse(dev, dev->width + 20, y_cent + 10, wt, ht);
+      wt += 20;
+      ht += 5;
+    }
+    for (uint16_t r = i; r <= dev->width; r += 20) {
+      circle(dev, x_cent, y_cent, r);
+    }
+  }
+}
+
+static void before(ssd1306_t *dev) {
+  demo_ellipses(dev, draw_ellipse_float, draw_circle_float);
+}
+
+static void after(ssd1306_t *dev) {
+  demo_ellipses(dev, ssd1306_draw_ellipse, ssd1306_draw_circle);
+}
+
+int main(void) {
+  bench_compare("demo_ellipses, 20 frames", before, after, 200);
+  return 0;
+}
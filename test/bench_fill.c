@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Filled rectangles as drawn by demo_fills in example.c
+
+#include "bench.h"
+
+typedef void (*rect_fn_t)(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+static void fill_per_pixel(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  for (int32_t i = MAX(x, 0); i < MIN(x + width, (int32_t) dev->width); i++) {
+    for (int32_t j = MAX(y, 0); j < MIN(y + height, (int32_t) dev->height); j++) {
+      ssd1306_draw_pixel(dev, i, j);
+    }
+  }
+}
+
+static void clear_per_pixel(ssd1306_t *dev, int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  for (int32_t i = MAX(x, 0); i < MIN(x + width, (int32_t) dev->width); i++) {
+    for (int32_t j = MAX(y, 0); j < MIN(y + height, (int32_t) dev->height); j++) {
+      ssd1306_clear_pixel(dev, i, j);
+    }
+  }
+}
+
+static void demo_fills(ssd1306_t *dev, rect_fn_t fill, rect_fn_t clear) {
+  int16_t x_cent = dev->width / 4;
+  int16_t y_cent = dev->height / 2;
+
+  for (uint16_t i = 0; i < 20; i++) {
+    for (int16_t r = dev->height + i; r > 0; r -= 20) {
+      fill(dev, x_cent - r / 2, y_cent - r / 2, r * 7 / 4, r);
+      if (r - 10 > 0) {
+        clear(dev, x_cent - r / 2 + 5, y_cent - r / 2 + 5, (r - 10) * 7 / 4, r - 10);
+      }
+    }
+  }
+}
+
+static void before(ssd1306_t *dev) {
+  demo_fills(dev, fill_per_pixel, clear_per_pixel);
+}
+
+static void after(ssd1306_t *dev) {
+  demo_fills(dev, ssd1306_fill_rect, ssd1306_clear_rect);
+}
+
+int main(void) {
+  return bench_compare("demo_fills, 20 frames", before, after, 200) != 0;
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// The Pico board image drawn bit by bit from rows against whole bytes from pages
+
+#include "bench.h"
+#include "tools/image_pico_board.h"
+
+static uint8_t pages[128 * ((196 + 7) / 8)];
+
+static const ssd1306_image_t image_pico_board_pages = {
+  .width = 128,
+  .height = 196,
+  .length = sizeof(pages),
+  .data = pages,
+  .format = SSD1306_IMAGE_PAGES,
+};
+
+static bool row_pixel(const ssd1306_image_t *image, uint16_t i, uint16_t j) {
+  uint16_t stride = (image->width + 7) / 8;
+  return image->data[j * stride + i / 8] & (0x80u >> (i % 8));
+}
+
+// What tools/bmp_to_h.py --layout pages would write out
+static void convert_to_pages(const ssd1306_image_t *image) {
+  for (uint16_t j = 0; j < image->height; j++) {
+    for (uint16_t i = 0; i < image->width; i++) {
+      if (row_pixel(image, i, j)) {
+        pages[(j / 8) * image->width + i] |= 1u << (j % 8);
+      }
+    }
+  }
+}
+
+static void draw_image_per_pixel(ssd1306_t *dev, uint16_t x, uint16_t y, const ssd1306_image_t *image) {
+  for (uint16_t j = 0; j < image->height; j++) {
+    for (uint16_t i = 0; i < image->width; i++) {
+      if (row_pixel(image, i, j)) {
+        ssd1306_draw_pixel(dev, x + i, y + j);
+      } else {
+        ssd1306_clear_pixel(dev, x + i, y + j);
+      }
+    }
+  }
+}
+
+static void before(ssd1306_t *dev) {
+  draw_image_per_pixel(dev, 0, 0, &image_pico_board);
+  draw_image_per_pixel(dev, 0, 3, &image_pico_board);
+}
+
+static void after(ssd1306_t *dev) {
+  ssd1306_draw_image(dev, 0, 0, &image_pico_board_pages);
+  ssd1306_draw_image(dev, 0, 3, &image_pico_board_pages);
+}
+
+int main(void) {
+  convert_to_pages(&image_pico_board);
+  return bench_compare("128x196 image, aligned and unaligned", before, after, 2000) != 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// A text status screen, half of its lines off the page grid
+
+#include "bench.h"
+#include "lib/fonts/font6x8.h"
+
+#define LINES 7
+
+static const char *text = "Temp 23.5C  Hum 81%";
+
+static void draw_str_per_pixel(ssd1306_t *dev, int x, int y, const char *str, const ssd1306_font_t *font) {
+  for (; *str; str++, x += font->width) {
+    uint8_t ch = (uint8_t) *str;
+    if (ch < font->first || ch >= font->first + font->count) {
+      continue;
+    }
+    for (uint8_t i = 0; i < font->width; i++) {
+      uint8_t line = font->data[(ch - font->first) * font->width + i];
+      for (uint8_t j = 0; j < font->height; j++, line >>= 1) {
+        if (line & 0x01u) {
+          ssd1306_draw_pixel(dev, x + i, y + j);
+        } else {
+          ssd1306_clear_pixel(dev, x + i, y + j);
+        }
+      }
+    }
+  }
+}
+
+static void before(ssd1306_t *dev) {
+  for (int line = 0; line < LINES; line++) {
+    draw_str_per_pixel(dev, 2, line * 9, text, &font6x8_font);
+  }
+}
+
+static void after(ssd1306_t *dev) {
+  for (int line = 0; line < LINES; line++) {
+    ssd1306_draw_str(dev, 2, line * 9, text, &font6x8_font);
+  }
+}
+
+int main(void) {
+  return bench_compare("status screen, 7 lines of text", before, after, 2000) != 0;
+}
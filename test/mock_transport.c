@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#include <string.h>
+#include "mock_transport.h"
+
+mock_panel_t mock_panel;
+
+// Argument bytes following each command that takes any
+static uint8_t command_args(uint8_t cmd) {
+  switch (cmd) {
+  case 0x21: case 0x22: case 0xA3:
+    return 2;
+  case 0x20: case 0x23: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD6:
+  case 0xD9: case 0xDA: case 0xDB:
+    return 1;
+  case 0x29: case 0x2A:
+    return 5;
+  case 0x26: case 0x27: case 0x2C: case 0x2D:
+    return 6;
+  default:
+    return 0;
+  }
+}
+
+static void run_command(const uint8_t *cmd) {
+  switch (cmd[0]) {
+  case 0x20:
+    mock_panel.mode = cmd[1] & 0x03;
+    break;
+  case 0x21:
+    mock_panel.col = mock_panel.col_start = cmd[1] % MOCK_PANEL_WIDTH;
+    mock_panel.col_end = cmd[2] % MOCK_PANEL_WIDTH;
+    break;
+  case 0x22:
+    mock_panel.page = mock_panel.page_start = cmd[1] % MOCK_PANEL_PAGES;
+    mock_panel.page_end = cmd[2] % MOCK_PANEL_PAGES;
+    break;
+  case 0x2C: case 0x2D:
+    // Content scroll moves the columns of each page in the range by one, leaving the
+    // exposed column as it was
+    for (uint8_t page = cmd[2] % MOCK_PANEL_PAGES; page <= cmd[4] % MOCK_PANEL_PAGES; page++) {
+      uint8_t *row = mock_panel.ram[page] + cmd[5];
+      size_t len = cmd[6] - cmd[5];
+
+      if (cmd[0] == 0x2D) {
+        memmove(row, row + 1, len);
+      } else {
+        memmove(row + 1, row, len);
+      }
+    }
+    break;
+  case 0x81:
+    mock_panel.contrast = cmd[1];
+    break;
+  case 0xA6: case 0xA7:
+    mock_panel.inverted = cmd[0] & 0x01;
+    break;
+  case 0xAE: case 0xAF:
+    mock_panel.display_on = cmd[0] & 0x01;
+    break;
+  default:
+    if (cmd[0] >= 0x40 && cmd[0] <= 0x7F) {
+      mock_panel.start_line = cmd[0] & 0x3F;
+    } else if (cmd[0] >= 0xB0 && cmd[0] <= 0xB7) {
+      mock_panel.page = cmd[0] & 0x07;
+    } else if (cmd[0] <= 0x0F) {
+      mock_panel.col = (mock_panel.col & 0xF0) | cmd[0];
+    } else if (cmd[0] <= 0x1F) {
+      mock_panel.col = ((cmd[0] & 0x0F) << 4 | (mock_panel.col & 0x0F)) % MOCK_PANEL_WIDTH;
+    }
+    break;
+  }
+}
+
+void mock_panel_reset(void) {
+  memset(&mock_panel, 0, sizeof(mock_panel));
+  mock_panel.col_end = MOCK_PANEL_WIDTH - 1;
+  mock_panel.page_end = MOCK_PANEL_PAGES - 1;
+  mock_panel.mode = 0x02;
+  mock_panel.contrast = 0x7F;
+}
+
+void mock_panel_reset_counts(void) {
+  mock_panel.transactions = 0;
+  mock_panel.cmd_bytes = 0;
+  mock_panel.data_bytes = 0;
+  mock_panel.cost = 0;
+}
+
+bool mock_panel_fail(void) {
+  if (mock_panel.fail_next == 0) {
+    return false;
+  }
+  mock_panel.fail_next--;
+  return true;
+}
+
+void mock_panel_command(uint8_t byte) {
+  mock_panel.cmd_bytes++;
+  mock_panel.cmd[mock_panel.cmd_len++] = byte;
+  if (mock_panel.cmd_len > command_args(mock_panel.cmd[0])) {
+    run_command(mock_panel.cmd);
+    mock_panel.cmd_len = 0;
+  }
+}
+
+void mock_panel_data(uint8_t byte) {
+  mock_panel.data_bytes++;
+  mock_panel.ram[mock_panel.page][mock_panel.col] = byte;
+  // Page addressing stays on its page, horizontal addressing wraps around the window
+  if (mock_panel.mode == 0x02) {
+    mock_panel.col = (mock_panel.col + 1) % MOCK_PANEL_WIDTH;
+  } else if (mock_panel.col != mock_panel.col_end) {
+    mock_panel.col++;
+  } else {
+    mock_panel.col = mock_panel.col_start;
+    mock_panel.page = mock_panel.page == mock_panel.page_end ? mock_panel.page_start : mock_panel.page + 1;
+  }
+}
+
+void mock_panel_i2c(const uint8_t *bytes, size_t len) {
+  // Each control byte says whether the next byte is a command or data, and whether only
+  // that one byte follows (Co set) or the rest of the transaction
+  size_t i = 0;
+
+  mock_panel.transactions++;
+  while (i < len) {
+    uint8_t control = bytes[i++];
+    size_t end = control & 0x80 ? i + 1 : len;
+
+    for (; i < end && i < len; i++) {
+      if (control & 0x40) {
+        mock_panel_data(bytes[i]);
+      } else {
+        mock_panel_command(bytes[i]);
+      }
+    }
+  }
+}
+
+bool mock_panel_matches(const ssd1306_t *dev) {
+  for (uint16_t page = 0; page < dev->pages; page++) {
+    if (memcmp(mock_panel.ram[page], dev->buff + page * dev->width, dev->width) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool mock_write_cmd(ssd1306_t *dev, const uint8_t *cmds, size_t len) {
+  if (mock_panel_fail()) {
+    return false;
+  }
+  mock_panel.transactions++;
+  mock_panel.cost += dev->transport->txn_overhead + len * dev->transport->cmd_bytes;
+  for (size_t i = 0; i < len; i++) {
+    mock_panel_command(cmds[i]);
+  }
+  dev->stats.transactions++;
+  dev->stats.bytes += len;
+  return true;
+}
+
+static bool mock_write_data(ssd1306_t *dev, const uint8_t *cmds, size_t cmd_len,
+                            uint8_t *data, size_t len) {
+  if (mock_panel_fail()) {
+    return false;
+  }
+  mock_panel.transactions++;
+  mock_panel.cost += dev->transport->txn_overhead + cmd_len * dev->transport->cmd_bytes + len;
+  for (size_t i = 0; i < cmd_len; i++) {
+    mock_panel_command(cmds[i]);
+  }
+  for (size_t i = 0; i < len; i++) {
+    mock_panel_data(data[i]);
+  }
+  dev->stats.transactions++;
+  dev->stats.bytes += cmd_len + len;
+  return true;
+}
+
+static bool mock_write_wire(ssd1306_t *dev, const uint8_t *data, size_t len) {
+  // Led by the data control byte like an I2C frame in flash
+  return mock_write_data(dev, NULL, 0, (uint8_t *) data + 1, len - 1);
+}
+
+const ssd1306_transport_t mock_transport = {
+  .write_cmd = mock_write_cmd,
+  .write_data = mock_write_data,
+  .write_wire = mock_write_wire,
+  .txn_overhead = 3,
+  .cmd_bytes = 2,
+};
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef MOCK_TRANSPORT_H
+#define MOCK_TRANSPORT_H
+
+#include "ssd1306.h"
+
+#define MOCK_PANEL_PAGES 8
+#define MOCK_PANEL_WIDTH 128
+
+// Model of the controller at the far end of the bus. Everything sent through the mock
+// transport, the I2C and SPI stand-ins and the DMA stand-in ends up here
+typedef struct {
+  uint8_t ram[MOCK_PANEL_PAGES][MOCK_PANEL_WIDTH];
+  // Address pointer and window, addressing mode as set by SET_MEM_ADDR (0 or 2)
+  uint8_t col;
+  uint8_t page;
+  uint8_t col_start;
+  uint8_t col_end;
+  uint8_t page_start;
+  uint8_t page_end;
+  uint8_t mode;
+  // Settings as last received
+  uint8_t start_line;
+  uint8_t contrast;
+  bool inverted;
+  bool display_on;
+  // Traffic seen: transactions, command bytes and display data bytes. cost adds up
+  // what the transport's txn_overhead and cmd_bytes say each transfer costs
+  uint32_t transactions;
+  uint32_t cmd_bytes;
+  uint32_t data_bytes;
+  uint32_t cost;
+  // Transactions that fail before any byte arrives, counted down as they do
+  uint16_t fail_next;
+  // Command byte being collected with its arguments
+  uint8_t cmd[8];
+  uint8_t cmd_len;
+} mock_panel_t;
+
+extern mock_panel_t mock_panel;
+
+// Transport that hands bytes straight to the mock panel. Costs match the I2C transport
+extern const ssd1306_transport_t mock_transport;
+
+// Power-on state: blank RAM, horizontal addressing over the whole panel, counters zeroed
+void mock_panel_reset(void);
+
+// Zero the traffic counters only
+void mock_panel_reset_counts(void);
+
+// Whether the next transaction fails, used up by each failure
+bool mock_panel_fail(void);
+
+// Feed one command or display data byte
+void mock_panel_command(uint8_t byte);
+void mock_panel_data(uint8_t byte);
+
+// Feed one I2C transaction, control bytes included
+void mock_panel_i2c(const uint8_t *bytes, size_t len);
+
+// Whether display RAM holds the frame buffer of dev, rows in display RAM order
+bool mock_panel_matches(const ssd1306_t *dev);
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef SDK_HARDWARE_DMA_H
+#define SDK_HARDWARE_DMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size {
+  DMA_SIZE_8 = 0,
+  DMA_SIZE_16 = 1,
+  DMA_SIZE_32 = 2,
+};
+
+typedef struct {
+  enum dma_channel_transfer_size size;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(unsigned int channel);
+dma_channel_config dma_channel_get_default_config(unsigned int channel);
+void channel_config_set_transfer_data_size(dma_channel_config *config, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *config, bool incr);
+void channel_config_set_write_increment(dma_channel_config *config, bool incr);
+void channel_config_set_dreq(dma_channel_config *config, unsigned int dreq);
+// Feeds the whole transfer to the mock panel at once. The completion interrupt is raised
+// straight away, or on the next tight_loop_contents while sdk_dma_defer is set
+void dma_channel_configure(unsigned int channel, const dma_channel_config *config,
+                           volatile void *write_addr, const volatile void *read_addr,
+                           unsigned int count, bool trigger);
+void dma_channel_abort(unsigned int channel);
+void dma_channel_set_irq0_enabled(unsigned int channel, bool enabled);
+bool dma_channel_get_irq0_status(unsigned int channel);
+void dma_channel_acknowledge_irq0(unsigned int channel);
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef SDK_HARDWARE_GPIO_H
+#define SDK_HARDWARE_GPIO_H
+
+#include <stdbool.h>
+
+#define GPIO_IN 0
+#define GPIO_OUT 1
+
+enum gpio_function {
+  GPIO_FUNC_SPI = 1,
+  GPIO_FUNC_I2C = 3,
+  GPIO_FUNC_SIO = 5,
+};
+
+void gpio_init(unsigned int gpio);
+void gpio_set_function(unsigned int gpio, enum gpio_function fn);
+void gpio_set_dir(unsigned int gpio, bool out);
+void gpio_put(unsigned int gpio, bool value);
+// Lines read high, nothing holds the bus
+bool gpio_get(unsigned int gpio);
+
+#endif
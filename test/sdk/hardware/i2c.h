@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef SDK_HARDWARE_I2C_H
+#define SDK_HARDWARE_I2C_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PICO_ERROR_GENERIC (-1)
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x200u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x40u
+#define I2C_IC_STATUS_TFE_BITS 0x04u
+#define I2C_IC_STATUS_MST_ACTIVITY_BITS 0x20u
+
+// Registers the driver touches
+typedef struct {
+  volatile uint32_t tar;
+  volatile uint32_t data_cmd;
+  volatile uint32_t raw_intr_stat;
+  volatile uint32_t clr_tx_abrt;
+  volatile uint32_t enable;
+  volatile uint32_t status;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+  i2c_hw_t hw;
+  unsigned int baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+unsigned int i2c_init(i2c_inst_t *i2c, unsigned int baudrate);
+unsigned int i2c_set_baudrate(i2c_inst_t *i2c, unsigned int baudrate);
+// Writes go to the mock panel, see mock_transport.h
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len,
+                         bool nostop, unsigned int timeout_us);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+  return &i2c->hw;
+}
+
+static inline unsigned int i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+  return (i2c == i2c1 ? 34 : 32) + !is_tx;
+}
+
+#endif
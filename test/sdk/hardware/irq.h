@@ -0,0 +1,21 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef SDK_HARDWARE_IRQ_H
+#define SDK_HARDWARE_IRQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DMA_IRQ_0 11
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+
+void irq_add_shared_handler(unsigned int num, irq_handler_t handler, uint8_t order_priority);
+void irq_set_enabled(unsigned int num, bool enabled);
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef SDK_HARDWARE_SPI_H
+#define SDK_HARDWARE_SPI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+  volatile uint32_t dr;
+} spi_hw_t;
+
+typedef struct spi_inst {
+  spi_hw_t hw;
+} spi_inst_t;
+
+extern spi_inst_t spi0_inst;
+extern spi_inst_t spi1_inst;
+#define spi0 (&spi0_inst)
+#define spi1 (&spi1_inst)
+
+// Bytes go to the mock panel as commands or data by the level of sdk_pin_dc
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+bool spi_is_busy(const spi_inst_t *spi);
+
+static inline spi_hw_t *spi_get_hw(spi_inst_t *spi) {
+  return &spi->hw;
+}
+
+static inline unsigned int spi_get_dreq(spi_inst_t *spi, bool is_tx) {
+  return (spi == spi1 ? 18 : 16) + !is_tx;
+}
+
+#endif
@@ -0,0 +1,16 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef SDK_HARDWARE_SYNC_H
+#define SDK_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+// Nothing interrupts the host build, the state is only counted to catch imbalance
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+#endif
@@ -0,0 +1,23 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef SDK_PICO_MUTEX_H
+#define SDK_PICO_MUTEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+  bool owned;
+} mutex_t;
+
+void mutex_init(mutex_t *mutex);
+// Aborts if the mutex is already held, there is nobody else to release it
+void mutex_enter_blocking(mutex_t *mutex);
+bool mutex_try_enter(mutex_t *mutex, uint32_t *owner_out);
+void mutex_exit(mutex_t *mutex);
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Host stand-ins for the parts of the Pico SDK the driver uses, see sdk.c
+
+#ifndef SDK_PICO_STDLIB_H
+#define SDK_PICO_STDLIB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+typedef unsigned int uint;
+
+#ifndef MIN
+#define MIN(a, b) ((b) > (a) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+// Busy-wait loops spin here, which lets a deferred DMA transfer complete
+void tight_loop_contents(void);
+
+#endif
@@ -0,0 +1,303 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#include <stdlib.h>
+#include <hardware/dma.h>
+#include <hardware/i2c.h>
+#include <hardware/irq.h>
+#include <hardware/spi.h>
+#include <hardware/sync.h>
+#include <pico/mutex.h>
+#include "mock_transport.h"
+#include "sdk.h"
+
+// Bit time of the stand-in SPI bus, 8 MHz
+#define SPI_NS_PER_BYTE 1000
+
+bool sdk_dma_defer;
+unsigned int sdk_pin_dc = 0xFF;
+repeating_timer_t *sdk_timer;
+uint32_t sdk_spins;
+uint32_t sdk_spi_busy_polls;
+
+i2c_inst_t i2c0_inst = {.hw = {.status = I2C_IC_STATUS_TFE_BITS}, .baudrate = 100000};
+i2c_inst_t i2c1_inst = {.hw = {.status = I2C_IC_STATUS_TFE_BITS}, .baudrate = 100000};
+spi_inst_t spi0_inst;
+spi_inst_t spi1_inst;
+
+static uint64_t now_us;
+static bool gpio_levels[32];
+static bool dma_claimed[NUM_DMA_CHANNELS];
+static bool dma_irq_pending[NUM_DMA_CHANNELS];
+static irq_handler_t dma_handler;
+static uint32_t irqs_disabled;
+
+uint32_t time_us_32(void) {
+  return (uint32_t) now_us;
+}
+
+uint64_t time_us_64(void) {
+  return now_us;
+}
+
+void sleep_us(uint64_t us) {
+  now_us += us;
+}
+
+void sleep_ms(uint32_t ms) {
+  now_us += ms * 1000ull;
+}
+
+void tight_loop_contents(void) {
+  sdk_spins++;
+  now_us++;
+  sdk_dma_complete();
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback,
+                            void *user_data, repeating_timer_t *out) {
+  out->delay_us = delay_us;
+  out->callback = callback;
+  out->user_data = user_data;
+  sdk_timer = out;
+  return true;
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+  if (sdk_timer == timer) {
+    sdk_timer = NULL;
+  }
+  return true;
+}
+
+void mutex_init(mutex_t *mutex) {
+  mutex->owned = false;
+}
+
+void mutex_enter_blocking(mutex_t *mutex) {
+  if (mutex->owned) {
+    abort();
+  }
+  mutex->owned = true;
+}
+
+bool mutex_try_enter(mutex_t *mutex, uint32_t *owner_out) {
+  (void) owner_out;
+  if (mutex->owned) {
+    return false;
+  }
+  mutex->owned = true;
+  return true;
+}
+
+void mutex_exit(mutex_t *mutex) {
+  mutex->owned = false;
+}
+
+void gpio_init(unsigned int gpio) {
+  gpio_levels[gpio % 32] = false;
+}
+
+void gpio_set_function(unsigned int gpio, enum gpio_function fn) {
+  (void) gpio;
+  (void) fn;
+}
+
+void gpio_set_dir(unsigned int gpio, bool out) {
+  (void) gpio;
+  (void) out;
+}
+
+void gpio_put(unsigned int gpio, bool value) {
+  gpio_levels[gpio % 32] = value;
+}
+
+bool gpio_get(unsigned int gpio) {
+  (void) gpio;
+  return true;
+}
+
+unsigned int i2c_init(i2c_inst_t *i2c, unsigned int baudrate) {
+  return i2c_set_baudrate(i2c, baudrate);
+}
+
+unsigned int i2c_set_baudrate(i2c_inst_t *i2c, unsigned int baudrate) {
+  i2c->baudrate = baudrate;
+  return baudrate;
+}
+
+static void i2c_wire_time(i2c_inst_t *i2c, size_t len) {
+  // Nine bit times per byte, address byte included
+  now_us += (len + 1) * 9 * 1000000ull / i2c->baudrate;
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len,
+                         bool nostop, unsigned int timeout_us) {
+  (void) addr;
+  (void) nostop;
+  (void) timeout_us;
+  i2c->hw.raw_intr_stat = 0;
+  if (mock_panel_fail()) {
+    // NACKed address, only the address byte went out
+    i2c_wire_time(i2c, 0);
+    return PICO_ERROR_GENERIC;
+  }
+  mock_panel_i2c(src, len);
+  i2c_wire_time(i2c, len);
+  return (int) len;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len) {
+  (void) spi;
+  bool data = gpio_levels[sdk_pin_dc % 32];
+
+  for (size_t i = 0; i < len; i++) {
+    if (data) {
+      mock_panel_data(src[i]);
+    } else {
+      mock_panel_command(src[i]);
+    }
+  }
+  now_us += len * SPI_NS_PER_BYTE / 1000;
+  return (int) len;
+}
+
+bool spi_is_busy(const spi_inst_t *spi) {
+  (void) spi;
+  if (sdk_spi_busy_polls > 0) {
+    sdk_spi_busy_polls--;
+    return true;
+  }
+  return false;
+}
+
+int dma_claim_unused_channel(bool required) {
+  for (int ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+    if (!dma_claimed[ch]) {
+      dma_claimed[ch] = true;
+      return ch;
+    }
+  }
+  if (required) {
+    abort();
+  }
+  return -1;
+}
+
+void dma_channel_unclaim(unsigned int channel) {
+  dma_claimed[channel] = false;
+}
+
+dma_channel_config dma_channel_get_default_config(unsigned int channel) {
+  (void) channel;
+  return (dma_channel_config){DMA_SIZE_32};
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *config, enum dma_channel_transfer_size size) {
+  config->size = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *config, bool incr) {
+  (void) config;
+  (void) incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *config, bool incr) {
+  (void) config;
+  (void) incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *config, unsigned int dreq) {
+  (void) config;
+  (void) dreq;
+}
+
+static i2c_inst_t *i2c_of(volatile void *data_cmd) {
+  return data_cmd == &i2c0_inst.hw.data_cmd ? &i2c0_inst : &i2c1_inst;
+}
+
+void dma_channel_configure(unsigned int channel, const dma_channel_config *config,
+                           volatile void *write_addr, const volatile void *read_addr,
+                           unsigned int count, bool trigger) {
+  (void) trigger;
+  if (config->size == DMA_SIZE_16) {
+    // I2C data/command words, a NACK aborts the whole transaction
+    i2c_inst_t *i2c = i2c_of(write_addr);
+    const volatile uint16_t *words = read_addr;
+    uint8_t *bytes = malloc(count);
+
+    for (unsigned int i = 0; i < count; i++) {
+      bytes[i] = words[i] & 0xFF;
+    }
+    i2c->hw.raw_intr_stat = 0;
+    if (mock_panel_fail()) {
+      i2c->hw.raw_intr_stat = I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+      i2c_wire_time(i2c, 0);
+    } else {
+      mock_panel_i2c(bytes, count);
+      i2c_wire_time(i2c, count);
+    }
+    free(bytes);
+  } else {
+    // SPI display data, D/C is already high
+    const volatile uint8_t *bytes = read_addr;
+
+    for (unsigned int i = 0; i < count; i++) {
+      mock_panel_data(bytes[i]);
+    }
+    now_us += count * SPI_NS_PER_BYTE / 1000;
+  }
+  dma_irq_pending[channel] = true;
+  if (!sdk_dma_defer) {
+    sdk_dma_complete();
+  }
+}
+
+void sdk_dma_complete(void) {
+  for (unsigned int ch = 0; ch < NUM_DMA_CHANNELS; ch++) {
+    if (dma_irq_pending[ch] && dma_handler) {
+      dma_handler();
+    }
+  }
+}
+
+void dma_channel_abort(unsigned int channel) {
+  dma_irq_pending[channel] = false;
+}
+
+void dma_channel_set_irq0_enabled(unsigned int channel, bool enabled) {
+  (void) channel;
+  (void) enabled;
+}
+
+bool dma_channel_get_irq0_status(unsigned int channel) {
+  return dma_irq_pending[channel];
+}
+
+void dma_channel_acknowledge_irq0(unsigned int channel) {
+  dma_irq_pending[channel] = false;
+}
+
+void irq_add_shared_handler(unsigned int num, irq_handler_t handler, uint8_t order_priority) {
+  (void) num;
+  (void) order_priority;
+  dma_handler = handler;
+}
+
+void irq_set_enabled(unsigned int num, bool enabled) {
+  (void) num;
+  (void) enabled;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+  return irqs_disabled++;
+}
+
+void restore_interrupts(uint32_t status) {
+  if (--irqs_disabled != status) {
+    abort();
+  }
+}
@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Knobs of the host SDK stand-ins for tests to turn
+
+#ifndef SDK_H
+#define SDK_H
+
+#include "pico/stdlib.h"
+
+// Hold DMA completion interrupts back until the next tight_loop_contents
+extern bool sdk_dma_defer;
+
+// GPIO whose level tells SPI bytes apart as commands (low) or data (high)
+extern unsigned int sdk_pin_dc;
+
+// Repeating timer last added, NULL once cancelled
+extern repeating_timer_t *sdk_timer;
+
+// Calls to tight_loop_contents, that is time spent waiting
+extern uint32_t sdk_spins;
+
+// Times the SPI stand-in reports busy before its TX FIFO has drained
+extern uint32_t sdk_spi_busy_polls;
+
+// Raise the completion interrupt of any DMA transfer still held back
+void sdk_dma_complete(void);
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+static int test_failures;
+
+// Report a failed check and carry on, main returns test_result()
+#define CHECK(cond)                                                  \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      test_failures++;                                               \
+    }                                                                \
+  } while (0)
+
+static inline int test_result(void) {
+  return test_failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// ssd1306_show_async over the DMA and I2C/SPI stand-ins, with the completion interrupt
+// held back until the driver waits for it
+
+#include "mock_transport.h"
+#include "sdk.h"
+#include "test.h"
+
+static int callbacks;
+
+static void on_done(ssd1306_t *dev, void *user_data) {
+  (void) dev;
+  (*(int *) user_data)++;
+}
+
+static void test_i2c(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init(&dev, 128, 64, 0x3C, i2c1, false));
+  ssd1306_fill_rect(&dev, 10, 10, 50, 30);
+  sdk_dma_defer = true;
+  callbacks = 0;
+  CHECK(ssd1306_show_async(&dev, on_done, &callbacks));
+  CHECK(ssd1306_async_busy(&dev));
+  CHECK(callbacks == 0);
+  // Only one flush at a time
+  CHECK(!ssd1306_show_async(&dev, on_done, &callbacks));
+  // The frame buffer is free again as soon as the flush started
+  ssd1306_clear(&dev);
+
+  ssd1306_async_wait(&dev);
+  CHECK(!ssd1306_async_busy(&dev));
+  CHECK(callbacks == 1);
+  CHECK(sdk_spins > 0);
+  sdk_dma_defer = false;
+
+  // Blocking flushes wait for the DMA one before they use the bus
+  ssd1306_draw_line(&dev, 0, 0, 127, 63);
+  CHECK(ssd1306_show_async(&dev, NULL, NULL));
+  CHECK(ssd1306_show(&dev));
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+static void test_i2c_nack(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init(&dev, 128, 64, 0x3C, i2c0, false));
+  CHECK(ssd1306_show(&dev));
+  ssd1306_reset_stats(&dev);
+  // An aborted transfer leaves the window unknown, so the next flush sends it again
+  mock_panel.fail_next = 1;
+  ssd1306_fill_rect(&dev, 0, 0, 20, 20);
+  CHECK(ssd1306_show_async(&dev, NULL, NULL));
+  ssd1306_async_wait(&dev);
+  CHECK(dev.stats.errors == 1);
+  CHECK(!mock_panel_matches(&dev));
+  CHECK(ssd1306_show_async(&dev, NULL, NULL));
+  ssd1306_async_wait(&dev);
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+static void test_spi(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  sdk_pin_dc = 20;
+  CHECK(ssd1306_init_spi(&dev, 128, 64, spi1, 20, 21, SSD1306_NO_PIN, false));
+  ssd1306_draw_circle(&dev, 64, 32, 20);
+  callbacks = 0;
+  CHECK(ssd1306_show_async(&dev, on_done, &callbacks));
+  ssd1306_async_wait(&dev);
+  CHECK(callbacks == 1);
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+static void test_bus_lock(void) {
+  ssd1306_t dev;
+  mutex_t lock;
+
+  mock_panel_reset();
+  mutex_init(&lock);
+  CHECK(ssd1306_init(&dev, 128, 64, 0x3C, i2c1, false));
+  ssd1306_set_bus_lock(&dev, &lock);
+  // The lock is held from the start of a DMA flush until it has completed
+  sdk_dma_defer = true;
+  CHECK(ssd1306_show_async(&dev, NULL, NULL));
+  CHECK(lock.owned);
+  ssd1306_async_wait(&dev);
+  CHECK(!lock.owned);
+  sdk_dma_defer = false;
+
+  // No DMA flush starts while another driver holds the lock
+  mutex_enter_blocking(&lock);
+  CHECK(!ssd1306_show_async(&dev, NULL, NULL));
+  CHECK(!ssd1306_async_busy(&dev));
+  mutex_exit(&lock);
+  ssd1306_fill_rect(&dev, 0, 0, 40, 40);
+  CHECK(ssd1306_show_async(&dev, NULL, NULL));
+  ssd1306_async_wait(&dev);
+  CHECK(!lock.owned);
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+static void test_spi_drain(void) {
+  ssd1306_t dev;
+  mutex_t lock;
+
+  mock_panel_reset();
+  mutex_init(&lock);
+  sdk_pin_dc = 20;
+  CHECK(ssd1306_init_spi(&dev, 128, 64, spi1, 20, 21, SSD1306_NO_PIN, false));
+  ssd1306_set_bus_lock(&dev, &lock);
+  sdk_dma_defer = true;
+  CHECK(ssd1306_show_async(&dev, NULL, NULL));
+  // The completion interrupt doesn't wait for the FIFO, the bus stays held until a poll
+  // finds it empty
+  sdk_spi_busy_polls = 2;
+  sdk_dma_complete();
+  CHECK(sdk_spi_busy_polls == 2);
+  CHECK(lock.owned);
+  CHECK(ssd1306_async_busy(&dev));
+  CHECK(ssd1306_async_busy(&dev));
+  CHECK(!ssd1306_async_busy(&dev));
+  CHECK(!lock.owned);
+  CHECK(mock_panel_matches(&dev));
+  sdk_dma_defer = false;
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_i2c();
+  test_i2c_nack();
+  test_spi();
+  test_bus_lock();
+  test_spi_drain();
+  return test_result();
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Chunked ssd1306_show: slices as ssd1306_chunk_info counts and prices them, with the
+// yield callback run between them
+
+#include "mock_transport.h"
+#include "test.h"
+
+static int yields;
+
+static void on_yield(ssd1306_t *dev, void *user_data) {
+  (void) dev;
+  (*(int *) user_data)++;
+}
+
+// Flush in slices of chunk_bytes and check the bus against ssd1306_chunk_info
+static void show_chunked(ssd1306_t *dev, uint16_t chunk_bytes, uint16_t slices) {
+  // The overhead is counted against the same frame sent in one transfer
+  ssd1306_set_chunking(dev, 0, NULL, NULL);
+  ssd1306_chunk_info_t single = ssd1306_chunk_info(dev);
+  ssd1306_set_chunking(dev, chunk_bytes, on_yield, &yields);
+  ssd1306_chunk_info_t info = ssd1306_chunk_info(dev);
+
+  yields = 0;
+  mock_panel_reset_counts();
+  CHECK(ssd1306_show(dev));
+  CHECK(info.slices == slices);
+  CHECK(mock_panel.transactions == slices);
+  CHECK(yields == slices - 1);
+  CHECK(mock_panel.cost == single.max_slice_cost + info.overhead);
+  CHECK(mock_panel.data_bytes == dev->buff_size);
+  CHECK(mock_panel_matches(dev));
+}
+
+static void test_chunked(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  ssd1306_clear(&dev);
+  ssd1306_draw_line(&dev, 0, 0, 127, 63);
+  show_chunked(&dev, 256, 4);
+
+  ssd1306_fill_rect(&dev, 30, 10, 60, 30);
+  show_chunked(&dev, 100, 16);
+
+  // Byte-sized slices reuse the page half of the window within a page: 3 + 2 * 3 for
+  // the column window and 1 data byte per slice, plus 2 * 3 for the page window on the
+  // first slice of each page
+  ssd1306_draw_circle(&dev, 64, 32, 20);
+  show_chunked(&dev, 1, 1024);
+  CHECK(mock_panel.cost == 1024 * (3 + 2 * 3 + 1) + 8 * 2 * 3);
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_chunked();
+  return test_result();
+}
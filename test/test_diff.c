@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// ssd1306_show_diff sends only the bytes that differ from the shadow of the last frame.
+// The mock transport costs 3 byte times per transaction and 2 per command
+
+#include "mock_transport.h"
+#include "test.h"
+
+static void test_diff(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  CHECK(ssd1306_enable_shadow(&dev));
+  // Until the shadow is in sync the whole frame goes out
+  ssd1306_clear(&dev);
+  ssd1306_draw_rect(&dev, 0, 0, 128, 64);
+  mock_panel_reset_counts();
+  CHECK(ssd1306_show_diff(&dev));
+  CHECK(mock_panel.data_bytes == 1024);
+  CHECK(mock_panel_matches(&dev));
+
+  // Nothing changed, nothing sent
+  mock_panel_reset_counts();
+  CHECK(ssd1306_show_diff(&dev));
+  CHECK(mock_panel.transactions == 0);
+
+  // A pixel set and cleared again is no change either, unlike for ssd1306_show_dirty
+  ssd1306_draw_pixel(&dev, 40, 20);
+  ssd1306_clear_pixel(&dev, 40, 20);
+  CHECK(ssd1306_show_diff(&dev));
+  CHECK(mock_panel.transactions == 0);
+
+  mock_panel_reset_counts();
+  // One changed byte: page addressing, a page and column, then the byte. 3 + 2 * 5 + 1
+  ssd1306_draw_pixel(&dev, 70, 40);
+  CHECK(ssd1306_show_diff(&dev));
+  CHECK(mock_panel.transactions == 1);
+  CHECK(mock_panel.data_bytes == 1);
+  CHECK(mock_panel.cost == 14);
+  CHECK(mock_panel_matches(&dev));
+
+  // Two runs of 4 bytes on one page, each with its page and column: 2 * (3 + 2 * 3 + 4)
+  mock_panel_reset_counts();
+  ssd1306_fill_rect(&dev, 10, 8, 4, 4);
+  ssd1306_fill_rect(&dev, 100, 8, 4, 4);
+  CHECK(ssd1306_show_diff(&dev));
+  CHECK(mock_panel.data_bytes == 8);
+  CHECK(mock_panel.cost == 26);
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_diff();
+  return test_result();
+}
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Failed transfers injected on the I2C stand-in and the mock transport: retries, error
+// counters, bounded transaction time and bus recovery
+
+#include "mock_transport.h"
+#include "sdk.h"
+#include "test.h"
+
+static void test_retries(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init(&dev, 128, 64, 0x3C, i2c1, false));
+  ssd1306_set_timeout(&dev, 500, 2);
+  ssd1306_reset_stats(&dev);
+  // Two NACKs are covered by the retries
+  mock_panel.fail_next = 2;
+  ssd1306_fill_rect(&dev, 0, 0, 64, 32);
+  CHECK(ssd1306_show(&dev));
+  CHECK(mock_panel_matches(&dev));
+  CHECK(dev.stats.errors == 2);
+  CHECK(dev.stats.retries == 2);
+  CHECK(dev.stats.recoveries == 0);
+  // Each attempt ends at its deadline at the latest
+  CHECK(dev.stats.max_txn_us <= 3 * 500 + 1024 * 9 * 1000000ull / i2c1->baudrate);
+  ssd1306_deinit(&dev);
+}
+
+static void test_recovery(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init(&dev, 128, 64, 0x3C, i2c1, false));
+  ssd1306_set_timeout(&dev, 500, 1);
+  ssd1306_contrast(&dev, 0x30);
+  CHECK(ssd1306_show(&dev));
+  ssd1306_reset_stats(&dev);
+
+  // A controller that lost its settings, then fails more often than the retries cover
+  mock_panel.contrast = 0x7F;
+  mock_panel.display_on = false;
+  mock_panel.fail_next = 2;
+  ssd1306_draw_pixel(&dev, 5, 5);
+  CHECK(!ssd1306_show_dirty(&dev));
+  CHECK(dev.stats.errors == 2);
+  CHECK(dev.stats.recoveries == 1);
+  // Recovery ran the init sequence again and put the settings in use back
+  CHECK(mock_panel.display_on);
+  CHECK(mock_panel.contrast == 0x30);
+  // The whole frame is sent again by the next flush
+  CHECK(ssd1306_show_dirty(&dev));
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+static void test_no_recovery(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  // The frame buffer holds whatever the allocation did until cleared
+  ssd1306_clear(&dev);
+  CHECK(ssd1306_show(&dev));
+  dev.auto_recover = false;
+  ssd1306_reset_stats(&dev);
+
+  // The failed frame stays dirty and goes out with the next flush
+  mock_panel.fail_next = 1;
+  ssd1306_fill_rect(&dev, 30, 20, 10, 10);
+  CHECK(!ssd1306_show_dirty(&dev));
+  CHECK(dev.stats.recoveries == 0);
+  CHECK(!mock_panel_matches(&dev));
+  CHECK(ssd1306_show_dirty(&dev));
+  CHECK(mock_panel_matches(&dev));
+
+  // Commands report failures too
+  mock_panel.fail_next = 1;
+  CHECK(!ssd1306_set_rows(&dev, 64, 0));
+  CHECK(ssd1306_recover(&dev));
+  CHECK(dev.stats.recoveries == 1);
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_retries();
+  test_recovery();
+  test_no_recovery();
+  return test_result();
+}
@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Row-format images as tools/bmp_to_h.py writes them, each row padded to whole bytes
+
+#include "mock_transport.h"
+#include "sdk.h"
+#include "test.h"
+
+static bool pixel(const ssd1306_t *dev, uint16_t x, uint16_t y) {
+  return dev->buff[x + dev->width * (y / 8)] & (1u << (y % 8));
+}
+
+static void test_odd_width(void) {
+  ssd1306_t dev;
+  // 10 pixels wide, so each row takes two bytes with the last 6 bits unused
+  static const uint8_t data[] = {
+    0xAA, 0xC0,
+    0x00, 0x40,
+    0xFF, 0xFF,
+  };
+  static const ssd1306_image_t image = {
+    .width = 10,
+    .height = 3,
+    .length = sizeof(data),
+    .data = data,
+  };
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  ssd1306_clear(&dev);
+  ssd1306_draw_image(&dev, 5, 6, &image);
+  for (uint16_t j = 0; j < image.height; j++) {
+    for (uint16_t i = 0; i < image.width; i++) {
+      bool on = data[j * 2 + i / 8] & (0x80u >> (i % 8));
+      CHECK(pixel(&dev, 5 + i, 6 + j) == on);
+    }
+  }
+  // Padding bits are not drawn
+  CHECK(!pixel(&dev, 15, 8));
+  CHECK(ssd1306_show(&dev));
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_odd_width();
+  return test_result();
+}
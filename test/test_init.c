@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Non-blocking init: one short transfer per ssd1306_init_poll, the first frame sent while
+// the charge pump settles. The mock transport costs 3 byte times per transaction and 2
+// per command
+
+#include "mock_transport.h"
+#include "sdk.h"
+#include "test.h"
+
+// Take one init step, checking it sent a single transfer of the given cost
+static bool poll_step(ssd1306_t *dev, uint32_t cost) {
+  mock_panel_reset_counts();
+  bool done = ssd1306_init_poll(dev);
+  CHECK(mock_panel.transactions == (cost ? 1 : 0));
+  CHECK(mock_panel.cost == cost);
+  return done;
+}
+
+static void test_init_poll(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport_async(&dev, 128, 64, &mock_transport, false));
+  CHECK(mock_panel.transactions == 0);
+  ssd1306_draw_rect(&dev, 0, 0, 128, 64);
+
+  // Config, then power: 16 and 9 commands
+  CHECK(!poll_step(&dev, 3 + 2 * 16));
+  CHECK(!poll_step(&dev, 3 + 2 * 9));
+  // The frame a page at a time, the first with the whole window and the rest with only
+  // the page half of it
+  CHECK(!poll_step(&dev, 3 + 2 * 6 + 128));
+  // Drawing on a page already sent stays dirty
+  ssd1306_draw_pixel(&dev, 60, 3);
+  for (uint8_t page = 1; page < 8; page++) {
+    CHECK(!poll_step(&dev, 3 + 2 * 3 + 128));
+  }
+  CHECK(!mock_panel.display_on);
+  // The panel is switched on once the charge pump has settled
+  CHECK(!poll_step(&dev, 0));
+  sleep_ms(100);
+  CHECK(poll_step(&dev, 3 + 2 * 1));
+  CHECK(mock_panel.display_on);
+  CHECK(dev.first_pixel_us >= 100000);
+  CHECK(!mock_panel_matches(&dev));
+  CHECK(ssd1306_show_dirty(&dev));
+  CHECK(mock_panel_matches(&dev));
+  // Nothing more to do
+  CHECK(poll_step(&dev, 0));
+  ssd1306_deinit(&dev);
+}
+
+static void test_init_retry(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport_async(&dev, 128, 32, &mock_transport, false));
+  // A failed step is taken again by the next poll
+  mock_panel.fail_next = 1;
+  CHECK(!poll_step(&dev, 0));
+  CHECK(!poll_step(&dev, 3 + 2 * 16));
+  while (!ssd1306_init_poll(&dev)) {
+    sleep_ms(10);
+  }
+  CHECK(mock_panel.display_on);
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_init_poll();
+  test_init_retry();
+  return test_result();
+}
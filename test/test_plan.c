@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// ssd1306_plan_spans picks the cheapest plan, and ssd1306_show_spans costs on the bus what
+// the plan said. The mock transport costs what the I2C transport does: 3 byte times per
+// transaction and 2 per command, so a window header is 15 and a page header 9
+
+#include "mock_transport.h"
+#include "test.h"
+
+static ssd1306_t dev;
+
+// Plan and send the spans, checking the bus cost against the plan
+static ssd1306_plan_t send(const ssd1306_span_t *spans, size_t count) {
+  ssd1306_plan_t plan = ssd1306_plan_spans(&dev, spans, count);
+
+  mock_panel_reset_counts();
+  CHECK(ssd1306_show_spans(&dev, spans, count));
+  CHECK(mock_panel.cost == plan.cost);
+  CHECK(mock_panel.transactions == plan.transfers);
+  CHECK(mock_panel_matches(&dev));
+  return plan;
+}
+
+static void test_full(void) {
+  ssd1306_span_t spans[8];
+
+  for (uint8_t page = 0; page < 8; page++) {
+    spans[page] = (ssd1306_span_t){page, 0, 125};
+    ssd1306_draw_pixel(&dev, 3 * page, 8 * page + 1);
+  }
+  // The last flush left the whole-frame window in place, so the frame goes out without
+  // window commands: 3 + 1024. Pages would cost 4 + 8 * (9 + 126)
+  ssd1306_plan_t plan = send(spans, 8);
+  CHECK(plan.mode == SSD1306_PLAN_FULL);
+  CHECK(plan.cost == 1027);
+  CHECK(mock_panel.data_bytes == 1024);
+}
+
+static void test_pages(void) {
+  const ssd1306_span_t spans[] = {{1, 5, 9}, {1, 12, 16}, {6, 100, 109}};
+
+  ssd1306_fill_rect(&dev, 5, 8, 5, 8);
+  ssd1306_fill_rect(&dev, 12, 8, 5, 8);
+  ssd1306_fill_rect(&dev, 100, 48, 10, 8);
+  // The 2-column gap is cheaper to send than a new header: switching to page mode plus
+  // (9 + 5) + (2 + 5) + (9 + 10). Windows would cost (15 + 12) + (15 + 10)
+  ssd1306_plan_t plan = send(spans, 3);
+  CHECK(plan.mode == SSD1306_PLAN_PAGES);
+  CHECK(plan.cost == 4 + 14 + 7 + 19);
+  CHECK(plan.transfers == 2);
+  CHECK(mock_panel.data_bytes == 22);
+}
+
+static void test_windows(void) {
+  const ssd1306_span_t span = {5, 70, 70};
+
+  // ssd1306_show_dirty leaves its window around the changed column. The spans sent so far
+  // are still in the dirty box, flushed first
+  CHECK(ssd1306_show_dirty(&dev));
+  ssd1306_draw_pixel(&dev, 70, 40);
+  CHECK(ssd1306_show_dirty(&dev));
+  // Writing the same window again needs no commands: 3 + 1. Pages would cost 4 + 9 + 1
+  ssd1306_draw_pixel(&dev, 70, 41);
+  ssd1306_plan_t plan = send(&span, 1);
+  CHECK(plan.mode == SSD1306_PLAN_WINDOWS);
+  CHECK(plan.cost == 4);
+  CHECK(mock_panel.data_bytes == 1);
+
+  // Stacked spans reuse the columns and only move the page: (15 + 10) + 2 * (9 + 10),
+  // against 4 + 3 * (9 + 10) for pages, which win
+  const ssd1306_span_t stacked[] = {{2, 10, 19}, {3, 10, 19}, {4, 10, 19}};
+  ssd1306_invert_rect(&dev, 10, 16, 10, 24);
+  plan = send(stacked, 3);
+  CHECK(plan.mode == SSD1306_PLAN_PAGES);
+  CHECK(plan.cost == 61);
+}
+
+static void test_full_from_page_mode(void) {
+  ssd1306_span_t spans[8];
+
+  for (uint8_t page = 0; page < 8; page++) {
+    spans[page] = (ssd1306_span_t){page, 0, 125};
+  }
+  ssd1306_clear(&dev);
+  // Back to horizontal addressing and a whole window header: 4 + 15 + 1024
+  ssd1306_plan_t plan = send(spans, 8);
+  CHECK(plan.mode == SSD1306_PLAN_FULL);
+  CHECK(plan.cost == 1043);
+}
+
+int main(void) {
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  CHECK(ssd1306_show(&dev));
+  test_full();
+  test_pages();
+  test_windows();
+  test_full_from_page_mode();
+  ssd1306_deinit(&dev);
+  return test_result();
+}
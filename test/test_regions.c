@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// ssd1306_show_regions sends each changed region at its own rate and within the bus
+// budget. The mock transport costs 3 byte times per transaction and 2 per command
+
+#include "mock_transport.h"
+#include "sdk.h"
+#include "test.h"
+
+static void test_rates(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  ssd1306_clear(&dev);
+  CHECK(ssd1306_show(&dev));
+  // A fast meter in the top left corner and slow chrome below it
+  CHECK(ssd1306_add_region(&dev, "meter", 0, 0, 64, 16, 50) == 0);
+  CHECK(ssd1306_add_region(&dev, "chrome", 0, 16, 128, 48, 1) == 1);
+  CHECK(ssd1306_find_region(&dev, "chrome") == &dev.regions[1]);
+
+  // Both are due straight away with all of their area
+  mock_panel_reset_counts();
+  ssd1306_show_regions(&dev);
+  CHECK(mock_panel.data_bytes == 64 * 2 + 128 * 6);
+  CHECK(mock_panel_matches(&dev));
+
+  // Only the meter is due again 20 ms later, with only its changed columns: one page of
+  // 10 columns, with both halves of the window. 3 + 2 * 6 + 10
+  ssd1306_fill_rect(&dev, 5, 2, 10, 4);
+  sleep_us(20000);
+  mock_panel_reset_counts();
+  ssd1306_show_regions(&dev);
+  CHECK(mock_panel.transactions == 1);
+  CHECK(mock_panel.data_bytes == 10);
+  CHECK(mock_panel.cost == 3 + 2 * 6 + 10);
+  CHECK(mock_panel_matches(&dev));
+
+  // The chrome waits for its second to be up, then sends the line's page in full
+  ssd1306_draw_line(&dev, 0, 40, 127, 40);
+  sleep_us(20000);
+  mock_panel_reset_counts();
+  ssd1306_show_regions(&dev);
+  CHECK(mock_panel.transactions == 0);
+  CHECK(!mock_panel_matches(&dev));
+  sleep_us(1000000);
+  ssd1306_show_regions(&dev);
+  CHECK(mock_panel.data_bytes == 128);
+  CHECK(mock_panel.cost == 3 + 2 * 6 + 128);
+  CHECK(mock_panel_matches(&dev));
+
+  // Changes outside every region are dropped
+  ssd1306_fill_rect(&dev, 100, 0, 10, 10);
+  sleep_us(2000000);
+  mock_panel_reset_counts();
+  ssd1306_show_regions(&dev);
+  CHECK(mock_panel.transactions == 0);
+  ssd1306_deinit(&dev);
+}
+
+static void test_budget(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  ssd1306_clear(&dev);
+  CHECK(ssd1306_show(&dev));
+  CHECK(ssd1306_add_region(&dev, "all", 0, 0, 128, 64, 0) == 0);
+  ssd1306_show_regions(&dev);
+
+  // Credit builds up at 1000 byte times a second, a 16-column page costs 3 + 2 * 6 + 16
+  ssd1306_set_bus_budget(&dev, 1000);
+  ssd1306_fill_rect(&dev, 20, 20, 16, 4);
+  mock_panel_reset_counts();
+  ssd1306_show_regions(&dev);
+  CHECK(mock_panel.transactions == 0);
+  sleep_us(20000);
+  ssd1306_show_regions(&dev);
+  CHECK(mock_panel.transactions == 0);
+  sleep_us(20000);
+  ssd1306_show_regions(&dev);
+  CHECK(mock_panel.cost == 3 + 2 * 6 + 16);
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_rates();
+  test_budget();
+  return test_result();
+}
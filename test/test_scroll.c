@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// Hardware scrolling on the mock panel: the content-scroll ticker and start-line scrolling
+
+#include "mock_transport.h"
+#include "sdk.h"
+#include "test.h"
+#include "lib/fonts/font6x8.h"
+
+static bool ticker_steps(ssd1306_t *dev, ssd1306_ticker_t *ticker, uint16_t steps) {
+  for (uint16_t i = 0; i < steps; i++) {
+    sleep_us(ticker->interval_us);
+    if (!ssd1306_ticker_step(dev, ticker)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void test_ticker(void) {
+  ssd1306_t dev;
+  ssd1306_ticker_t ticker;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  ssd1306_clear(&dev);
+  CHECK(ssd1306_show(&dev));
+  CHECK(ssd1306_ticker_start(&dev, &ticker, "Ticker", &font6x8_font, 2, 50, true));
+  CHECK(ticker_steps(&dev, &ticker, 20));
+  CHECK(mock_panel_matches(&dev));
+
+  // The page row follows the start line around display RAM
+  ssd1306_scroll_lines(&dev, 8);
+  CHECK(ssd1306_ticker_start(&dev, &ticker, "Ticker", &font6x8_font, 2, 50, true));
+  CHECK(ticker_steps(&dev, &ticker, 20));
+  CHECK(mock_panel_matches(&dev));
+  CHECK(mock_panel.ram[3][127] != 0);
+
+  // Rows between page boundaries can't be scrolled by the controller
+  ssd1306_scroll_lines(&dev, 3);
+  CHECK(!ticker_steps(&dev, &ticker, 1));
+  CHECK(!ssd1306_ticker_start(&dev, &ticker, "Ticker", &font6x8_font, 2, 50, true));
+  ssd1306_scroll_lines(&dev, -3);
+
+  // A failed step leaves the row dirty for the next flush
+  CHECK(ssd1306_ticker_start(&dev, &ticker, "Ticker", &font6x8_font, 2, 50, true));
+  CHECK(ticker_steps(&dev, &ticker, 5));
+  dev.auto_recover = false;
+  mock_panel.fail_next = 1;
+  CHECK(!ticker_steps(&dev, &ticker, 1));
+  CHECK(!mock_panel_matches(&dev));
+  CHECK(ssd1306_show_dirty(&dev));
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+static void test_scroll_lines(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  ssd1306_fill_rect(&dev, 0, 0, 128, 64);
+  CHECK(ssd1306_show(&dev));
+
+  // The new start line travels with the page scrolled in, in one transaction
+  mock_panel_reset_counts();
+  CHECK(ssd1306_scroll_lines(&dev, 8));
+  CHECK(mock_panel.transactions == 1);
+  CHECK(mock_panel.start_line == 8);
+  CHECK(mock_panel_matches(&dev));
+
+  // Nothing to send but the start line when only blank rows move
+  ssd1306_clear(&dev);
+  CHECK(ssd1306_show(&dev));
+  mock_panel_reset_counts();
+  CHECK(ssd1306_scroll_lines(&dev, 8));
+  CHECK(mock_panel.transactions == 1);
+  CHECK(mock_panel.data_bytes == 0);
+  CHECK(mock_panel.start_line == 16);
+
+  // A failed transfer leaves the scrolled pages and the start line to the next flush
+  ssd1306_fill_rect(&dev, 0, 0, 128, 64);
+  CHECK(ssd1306_show(&dev));
+  dev.auto_recover = false;
+  mock_panel.fail_next = 1;
+  CHECK(!ssd1306_scroll_lines(&dev, -4));
+  CHECK(ssd1306_show_dirty(&dev));
+  CHECK(mock_panel.start_line == 12);
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_ticker();
+  test_scroll_lines();
+  return test_result();
+}
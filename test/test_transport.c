@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2025 tapiocode
+ * https://github.com/tapiocode
+ * MIT License
+ */
+
+// The mock, I2C and SPI transports all leave display RAM holding the frame buffer
+
+#include "mock_transport.h"
+#include "sdk.h"
+#include "test.h"
+
+static void draw_test_pattern(ssd1306_t *dev) {
+  ssd1306_draw_rect(dev, 0, 0, dev->width, dev->height);
+  ssd1306_draw_line(dev, 0, 0, dev->width - 1, dev->height - 1);
+  ssd1306_fill_rect(dev, 20, 5, 30, 11);
+}
+
+static void test_mock(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  CHECK(mock_panel.display_on);
+  draw_test_pattern(&dev);
+  CHECK(ssd1306_show(&dev));
+  CHECK(mock_panel_matches(&dev));
+
+  // A changed pixel is sent as a one-column window
+  mock_panel_reset_counts();
+  ssd1306_draw_pixel(&dev, 70, 40);
+  CHECK(ssd1306_show_dirty(&dev));
+  CHECK(mock_panel_matches(&dev));
+  CHECK(mock_panel.transactions == 1);
+  CHECK(mock_panel.data_bytes == 1);
+
+  // Settings follow the frame buffer's row order
+  ssd1306_scroll_lines(&dev, 10);
+  CHECK(mock_panel.start_line == dev.start_line);
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+static void test_i2c(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init(&dev, 128, 32, 0x3C, i2c1, false));
+  draw_test_pattern(&dev);
+  ssd1306_reset_stats(&dev);
+  mock_panel_reset_counts();
+  CHECK(ssd1306_show(&dev));
+  CHECK(mock_panel_matches(&dev));
+  // The whole frame in one transaction
+  CHECK(dev.stats.transactions == 1);
+  CHECK(mock_panel.transactions == 1);
+  CHECK(mock_panel.data_bytes == 4 * 128);
+  ssd1306_deinit(&dev);
+}
+
+static void test_spi(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  sdk_pin_dc = 20;
+  CHECK(ssd1306_init_spi(&dev, 128, 64, spi0, 20, 21, 22, false));
+  draw_test_pattern(&dev);
+  CHECK(ssd1306_show(&dev));
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_clear_rect(&dev, 20, 5, 30, 11);
+  CHECK(ssd1306_show_dirty(&dev));
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+static void test_power_cycle(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  // Settings changed while the display is off take effect when it is switched back on
+  ssd1306_power_off(&dev);
+  CHECK(!mock_panel.display_on);
+  ssd1306_contrast(&dev, 0x10);
+  ssd1306_invert(&dev, 1);
+  mock_panel_reset_counts();
+  ssd1306_power_on(&dev);
+  CHECK(mock_panel.display_on);
+  CHECK(mock_panel.contrast == 0x10);
+  CHECK(mock_panel.inverted);
+  CHECK(mock_panel.transactions == 1);
+  ssd1306_deinit(&dev);
+}
+
+static void test_set_rows(void) {
+  ssd1306_t dev;
+
+  mock_panel_reset();
+  CHECK(ssd1306_init_transport(&dev, 128, 64, &mock_transport, false));
+  // Shadow and front buffers made while fewer rows are driven still cover the whole panel
+  CHECK(ssd1306_set_rows(&dev, 32, 0));
+  CHECK(ssd1306_enable_shadow(&dev));
+  CHECK(ssd1306_enable_double_buffer(&dev, true));
+  draw_test_pattern(&dev);
+  CHECK(ssd1306_swap(&dev));
+  CHECK(ssd1306_show_diff(&dev));
+  CHECK(mock_panel_matches(&dev));
+
+  CHECK(ssd1306_set_rows(&dev, 64, 0));
+  draw_test_pattern(&dev);
+  CHECK(ssd1306_show(&dev));
+  CHECK(ssd1306_swap(&dev));
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_fill_rect(&dev, 10, 40, 20, 20);
+  CHECK(ssd1306_show_diff(&dev));
+  CHECK(mock_panel_matches(&dev));
+  ssd1306_deinit(&dev);
+}
+
+int main(void) {
+  test_mock();
+  test_set_rows();
+  test_power_cycle();
+  test_i2c();
+  test_spi();
+  return test_result();
+}
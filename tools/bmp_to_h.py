@@ -123,6 +123,62 @@ def _read_image(path: pathlib.Path, prefer: str, invert: bool) -> tuple[int, int
 	return width, height_abs, bytes(packed)
 
 
+def _to_pages(width: int, height: int, data: bytes, out_width: int, out_height: int) -> bytes:
+	"""Lay the image out as display pages of column bytes, LSB on top, cropped or padded."""
+	bytes_per_row = (width + 7) // 8
+
+	def pixel(x: int, y: int) -> int:
+		if x >= width or y >= height:
+			return 0
+		return (data[y * bytes_per_row + x // 8] >> (7 - x % 8)) & 0x01
+
+	pages = bytearray()
+	for page in range((out_height + 7) // 8):
+		for x in range(out_width):
+			byte = 0
+			for bit in range(8):
+				byte |= pixel(x, page * 8 + bit) << bit
+			pages.append(byte)
+	return bytes(pages)
+
+
+def _to_frame(width: int, height: int, data: bytes, frame_width: int, frame_height: int) -> bytes:
+	"""Lay the image out as display pages led by the data control byte."""
+	return bytes([0x40]) + _to_pages(width, height, data, frame_width, frame_height)
+
+
+def _parse_size(value: str) -> tuple[int, int]:
+	match = re.fullmatch(r"(\d+)x(\d+)", value)
+	if not match or int(match.group(2)) % 8:
+		raise argparse.ArgumentTypeError("expected WIDTHxHEIGHT with the height a multiple of 8")
+	return int(match.group(1)), int(match.group(2))
+
+
+def _render_frame_header(width: int, height: int, data: bytes, struct_name: str, data_name: str) -> str:
+	guard = f"{struct_name.upper()}_H"
+	byte_literals = [f"0x{value:02X}" for value in data]
+	lines = []
+	for i in range(0, len(byte_literals), 12):
+		lines.append(", ".join(byte_literals[i : i + 12]))
+	data_block = ",\n    ".join(lines)
+
+	return (
+		f"#ifndef {guard}\n"
+		f"#define {guard}\n\n"
+		f"#include \"pico/stdlib.h\"\n"
+		f"#include \"lib/image.h\"\n\n"
+		f"static const uint8_t {data_name}[{len(data)}] = {{\n"
+		f"    {data_block}\n"
+		f"}};\n\n"
+		f"static const ssd1306_frame_t {struct_name} = {{\n"
+		f"    .width = {width},\n"
+		f"    .height = {height},\n"
+		f"    .data = {data_name},\n"
+		f"}};\n\n"
+		f"#endif // {guard}\n"
+	)
+
+
 def _render_header(
 	image_path: pathlib.Path,
 	width: int,
@@ -130,6 +186,7 @@ def _render_header(
 	data: bytes,
 	struct_name: str,
 	data_name: str,
+	layout: str,
 ) -> str:
 	guard = f"{struct_name.upper()}_H"
 	byte_literals = [f"0x{value:02X}" for value in data]
@@ -137,6 +194,8 @@ def _render_header(
 	for i in range(0, len(byte_literals), 12):
 		lines.append(", ".join(byte_literals[i : i + 12]))
 	data_block = ",\n    ".join(lines)
+	# Row-major images leave the format out, as headers made before it existed do
+	format_line = "    .format = SSD1306_IMAGE_PAGES,\n" if layout == "pages" else ""
 
 	return (
 		f"#ifndef {guard}\n"
@@ -151,6 +210,7 @@ def _render_header(
 		f"    .height = {height},\n"
 		f"    .length = sizeof({data_name}),\n"
 		f"    .data = {data_name},\n"
+		f"{format_line}"
 		f"}};\n\n"
 		f"#endif // {guard}\n"
 	)
@@ -179,6 +239,18 @@ def main() -> None:
 		action="store_true",
 		help="Invert the mapping between palette and active pixels",
 	)
+	parser.add_argument(
+		"--frame",
+		type=_parse_size,
+		metavar="WIDTHxHEIGHT",
+		help="Emit a full display frame in wire format for ssd1306_show_flash instead of an image",
+	)
+	parser.add_argument(
+		"--layout",
+		choices=("rows", "pages"),
+		default="rows",
+		help="Image byte order: row-major, or display pages for faster drawing",
+	)
 
 	args = parser.parse_args()
 
@@ -193,7 +265,14 @@ def main() -> None:
 	data_name = f"{base_ident}_data"
 
 	output_path = args.output or input_path.with_suffix(".h")
-	header_content = _render_header(input_path, width, height, data, struct_name, data_name)
+	if args.frame:
+		frame_width, frame_height = args.frame
+		frame = _to_frame(width, height, data, frame_width, frame_height)
+		header_content = _render_frame_header(frame_width, frame_height, frame, struct_name, data_name)
+	else:
+		if args.layout == "pages":
+			data = _to_pages(width, height, data, width, height)
+		header_content = _render_header(input_path, width, height, data, struct_name, data_name, args.layout)
 	output_path.write_text(header_content)
 
 